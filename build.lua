@@ -44,6 +44,12 @@ precore.make_config("duct.dep", nil, {
 		includedirs {
 			G"${DUCT_ROOT}/",
 		}
+
+	-- ScriptParser::process_parallel()
+	configuration {"linux"}
+		links {
+			"pthread",
+		}
 end}})
 
 precore.apply_global({
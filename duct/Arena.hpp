@@ -0,0 +1,407 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief Arena and ArenaAllocator classes.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace duct {
+
+// Forward declarations
+class Arena;
+template<class T>
+class ArenaAllocator;
+
+/**
+	@addtogroup utils
+	@{
+*/
+
+/**
+	Monotonic memory arena.
+
+	@note Memory is allocated from a list of blocks and is only freed
+	when the arena is released or destroyed, so everything allocated
+	from an arena is freed in one step and allocations made in order
+	are adjacent in memory.
+
+	@note An arena cannot be moved, since allocators refer to it by
+	address.
+
+	@sa ArenaAllocator
+*/
+class Arena final {
+public:
+	class Scope;
+
+private:
+	struct Block {
+		Block* next;
+		std::size_t size;
+	};
+
+	enum : std::size_t {
+		max_block_size = 1u << 20
+	};
+
+	Block* m_head{nullptr};
+	char* m_pos{nullptr};
+	char* m_end{nullptr};
+	std::size_t m_block_size;
+	std::size_t m_capacity{0u};
+
+	static Arena*&
+	current_ref() noexcept {
+		static thread_local Arena* s_current{nullptr};
+		return s_current;
+	}
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/**
+		Construct with initial block size.
+
+		@note Blocks double in size (up to 1MiB) as the arena grows.
+
+		@param block_size Size of the first block in bytes.
+	*/
+	explicit
+	Arena(
+		std::size_t const block_size = 4096u
+	) noexcept
+		: m_block_size(block_size)
+	{}
+
+	/** Copy constructor (deleted). */
+	Arena(Arena const&) = delete;
+
+	/** Move constructor (deleted). */
+	Arena(Arena&&) = delete;
+
+	/** Destructor. */
+	~Arena() {
+		release();
+	}
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	Arena& operator=(Arena const&) = delete;
+
+	/** Move assignment operator (deleted). */
+	Arena& operator=(Arena&&) = delete;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get capacity.
+
+		@returns The total size of all blocks in bytes.
+	*/
+	std::size_t
+	capacity() const noexcept {
+		return m_capacity;
+	}
+
+	/**
+		Get the current arena for this thread.
+
+		@returns The innermost active Scope's arena, or @c nullptr if
+		there is none.
+	*/
+	static Arena*
+	current() noexcept {
+		return current_ref();
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Allocate memory.
+
+		@throws std::bad_alloc If a block could not be allocated.
+
+		@returns Memory of at least @a size bytes aligned to @a align.
+		@param size Size in bytes.
+		@param align Alignment in bytes; must be a power of two.
+	*/
+	void*
+	allocate(
+		std::size_t const size,
+		std::size_t const align = alignof(std::max_align_t)
+	);
+
+	/**
+		Free all memory.
+
+		@warning Everything allocated from the arena is invalidated.
+	*/
+	void
+	release() noexcept;
+/// @}
+};
+
+/**
+	Arena scope.
+
+	@note While a scope is active, default-constructed ArenaAllocator
+	objects on the same thread allocate from its arena. Scopes nest;
+	the previous arena is restored when a scope is destroyed.
+*/
+class Arena::Scope final {
+private:
+	Arena* m_previous;
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/**
+		Construct with arena.
+
+		@param arena Arena to make current; @c nullptr makes
+		ArenaAllocator use the heap.
+	*/
+	explicit
+	Scope(
+		Arena* const arena
+	) noexcept
+		: m_previous(Arena::current_ref())
+	{
+		Arena::current_ref() = arena;
+	}
+
+	/** Copy constructor (deleted). */
+	Scope(Scope const&) = delete;
+
+	/** Destructor. */
+	~Scope() {
+		Arena::current_ref() = m_previous;
+	}
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	Scope& operator=(Scope const&) = delete;
+/// @}
+};
+
+/**
+	Allocator which allocates from an Arena.
+
+	@note This can be used as #DUCT_CONFIG_ALLOCATOR, which makes all
+	auxiliary stdlib specializations (and thus Var) arena-aware.
+	An allocator constructed by default uses Arena::current(). Without
+	an arena, memory is allocated from the heap.
+
+	@note Deallocation is a no-op for arena memory. Containers take
+	their allocator along when moved or swapped; copies of containers
+	use the current arena (or the heap).
+
+	@warning Containers using an arena must not outlive it.
+
+	@tparam T Value type.
+*/
+template<class T>
+class ArenaAllocator {
+	template<class U>
+	friend class ArenaAllocator;
+
+private:
+	Arena* m_arena;
+
+public:
+/** @name Types */ /// @{
+	/** Value type. */
+	using value_type = T;
+
+	/** Whether to propagate on container copy assignment. */
+	using propagate_on_container_copy_assignment = std::false_type;
+	/** Whether to propagate on container move assignment. */
+	using propagate_on_container_move_assignment = std::true_type;
+	/** Whether to propagate on container swap. */
+	using propagate_on_container_swap = std::true_type;
+
+	/** Rebind to another value type. */
+	template<class U>
+	struct rebind {
+		/** Rebound allocator type. */
+		using other = ArenaAllocator<U>;
+	};
+/// @}
+
+/** @name Constructors and destructor */ /// @{
+	/** Construct with the current arena. */
+	ArenaAllocator() noexcept
+		: m_arena(Arena::current())
+	{}
+
+	/**
+		Construct with arena.
+
+		@param arena Arena; @c nullptr to use the heap.
+	*/
+	explicit
+	ArenaAllocator(
+		Arena* const arena
+	) noexcept
+		: m_arena(arena)
+	{}
+
+	/** Converting constructor. */
+	template<class U>
+	ArenaAllocator(
+		ArenaAllocator<U> const& other
+	) noexcept
+		: m_arena(other.m_arena)
+	{}
+
+	/** Copy constructor. */
+	ArenaAllocator(ArenaAllocator const&) noexcept = default;
+	/** Destructor. */
+	~ArenaAllocator() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	ArenaAllocator& operator=(ArenaAllocator const&) noexcept = default;
+
+	/** Equality operator. */
+	template<class U>
+	bool
+	operator==(
+		ArenaAllocator<U> const& other
+	) const noexcept {
+		return m_arena == other.m_arena;
+	}
+
+	/** Inequality operator. */
+	template<class U>
+	bool
+	operator!=(
+		ArenaAllocator<U> const& other
+	) const noexcept {
+		return m_arena != other.m_arena;
+	}
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get arena.
+
+		@returns The arena, or @c nullptr if the heap is used.
+	*/
+	Arena*
+	arena() const noexcept {
+		return m_arena;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Allocate storage.
+
+		@param count Number of objects.
+	*/
+	T*
+	allocate(
+		std::size_t const count
+	) {
+		if (nullptr != m_arena) {
+			return static_cast<T*>(
+				m_arena->allocate(count * sizeof(T), alignof(T))
+			);
+		} else {
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+	}
+
+	/**
+		Deallocate storage.
+
+		@param ptr Storage.
+	*/
+	void
+	deallocate(
+		T* const ptr,
+		std::size_t const /*count*/
+	) noexcept {
+		if (nullptr == m_arena) {
+			::operator delete(ptr);
+		}
+	}
+
+	/**
+		Get the allocator for a copy of a container.
+
+		@returns An allocator with the current arena.
+	*/
+	ArenaAllocator
+	select_on_container_copy_construction() const noexcept {
+		return ArenaAllocator{};
+	}
+/// @}
+};
+
+/** @} */ // end of doc-group utils
+
+inline void*
+Arena::allocate(
+	std::size_t const size,
+	std::size_t const align
+) {
+	std::uintptr_t const mask = align - 1u;
+	char* aligned = reinterpret_cast<char*>(
+		(reinterpret_cast<std::uintptr_t>(m_pos) + mask) & ~mask
+	);
+	if (
+		nullptr == m_pos || m_end < aligned ||
+		size > static_cast<std::size_t>(m_end - aligned)
+	) {
+		// Blocks are aligned for any fundamental type
+		std::size_t const header
+			= (sizeof(Block) + alignof(std::max_align_t) - 1u)
+			& ~(alignof(std::max_align_t) - 1u)
+		;
+		std::size_t block_size = m_block_size;
+		if (size + align > block_size) {
+			block_size = size + align;
+		} else if (max_block_size > m_block_size) {
+			m_block_size *= 2u;
+		}
+		Block* const block = static_cast<Block*>(
+			::operator new(header + block_size)
+		);
+		block->next = m_head;
+		block->size = block_size;
+		m_head = block;
+		m_capacity += block_size;
+		m_pos = reinterpret_cast<char*>(block) + header;
+		m_end = m_pos + block_size;
+		aligned = reinterpret_cast<char*>(
+			(reinterpret_cast<std::uintptr_t>(m_pos) + mask) & ~mask
+		);
+	}
+	m_pos = aligned + size;
+	return aligned;
+}
+
+inline void
+Arena::release() noexcept {
+	while (nullptr != m_head) {
+		Block* const next = m_head->next;
+		::operator delete(m_head);
+		m_head = next;
+	}
+	m_pos = m_end = nullptr;
+	m_capacity = 0u;
+}
+
+} // namespace duct
@@ -11,9 +11,12 @@
 #include "./aux.hpp"
 #include "./char.hpp"
 #include "./CharacterSet.hpp"
+#include "./CompiledCharacterSet.hpp"
 #include "./EncodingUtils.hpp"
 #include "./StringUtils.hpp"
+#include "./detail/arithmetic.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <type_traits>
 
@@ -29,6 +32,11 @@ class CharBuf;
 
 /**
 	Character buffer.
+
+	@note The buffer can refer to a slice of UTF-8 data instead of
+	owning its characters (see push_back(char const*, char const*)).
+	A slice is only valid as long as the data it refers to; it is
+	converted to owned characters if it cannot be extended in place.
 */
 class CharBuf final {
 public:
@@ -39,6 +47,12 @@ public:
 
 private:
 	duct::aux::vector<char_type> m_buffer{};
+	char const* m_slice_begin{nullptr};
+	char const* m_slice_end{nullptr};
+	// Number of code points in the slice, and the start of an
+	// incomplete sequence at its end (counted as one), or its end
+	std::size_t m_slice_size{0u};
+	char const* m_slice_tail{nullptr};
 	bool m_cached{false};
 	u8string m_cache_string{};
 
@@ -82,7 +96,7 @@ public:
 	*/
 	std::size_t
 	size() const noexcept {
-		return m_buffer.size();
+		return is_slice() ? m_slice_size : m_buffer.size();
 	}
 
 	/**
@@ -101,7 +115,37 @@ public:
 	*/
 	bool
 	empty() const noexcept {
-		return m_buffer.empty();
+		return !is_slice() && m_buffer.empty();
+	}
+
+	/**
+		Check if the buffer refers to a slice of UTF-8 data.
+	*/
+	bool
+	is_slice() const noexcept {
+		return m_slice_begin != m_slice_end;
+	}
+
+	/**
+		Get beginning of slice.
+
+		@returns The beginning of the slice (@c nullptr if
+		<code>is_slice() == false</code>).
+	*/
+	char const*
+	slice_begin() const noexcept {
+		return m_slice_begin;
+	}
+
+	/**
+		Get end of slice.
+
+		@returns The end of the slice (@c nullptr if
+		<code>is_slice() == false</code>).
+	*/
+	char const*
+	slice_end() const noexcept {
+		return m_slice_end;
 	}
 /// @}
 
@@ -113,6 +157,8 @@ public:
 	reset() noexcept {
 		m_cached = false;
 		m_buffer.clear();
+		m_slice_begin = m_slice_end = m_slice_tail = nullptr;
+		m_slice_size = 0u;
 	}
 
 	/**
@@ -123,9 +169,13 @@ public:
 	u8string const&
 	cache() {
 		if (!m_cached) {
-			StringUtils::convert<UTF32Utils>(
-				m_cache_string, m_buffer.cbegin(), m_buffer.cend()
-			);
+			if (is_slice()) {
+				m_cache_string.assign(m_slice_begin, m_slice_end);
+			} else {
+				StringUtils::convert<UTF32Utils>(
+					m_cache_string, m_buffer.cbegin(), m_buffer.cend()
+				);
+			}
 			m_cached = true;
 		}
 		return m_cache_string;
@@ -146,12 +196,66 @@ public:
 		char_type const cp
 	) {
 		if (DUCT_UNI_IS_CP_VALID(cp)) {
+			spill();
 			grow();
 			m_buffer.push_back(cp);
 			m_cached = false;
 		}
 	}
 
+	/**
+		Convert the buffer's slice (if any) to owned characters.
+
+		@note This must be called before the data a slice refers to
+		is released if the buffer is still needed.
+		@warning An exception may be thrown by internal resizing.
+	*/
+	void
+	detach() {
+		spill();
+	}
+
+	/**
+		Append UTF-8 data to the end of the buffer.
+
+		@note If the buffer is empty or is a slice ending at @a begin,
+		the buffer will refer to the data (extending the slice) instead
+		of copying it. Otherwise, the data is decoded into the buffer.
+
+		@warning The data must be valid UTF-8 and must outlive the
+		buffer's slice. An incomplete sequence at the end of the
+		buffer is one @c CHAR_REPLACEMENT.
+		@warning An exception may be thrown by internal resizing.
+
+		@note The cached string will be invalidated by this operation.
+
+		@param begin Beginning of data.
+		@param end End of data.
+	*/
+	void
+	push_back(
+		char const* const begin,
+		char const* const end
+	) {
+		if (begin == end) {
+			return;
+		} else if (m_buffer.empty() && (!is_slice() || m_slice_end == begin)) {
+			if (!is_slice()) {
+				m_slice_begin = m_slice_tail = begin;
+				m_slice_size = 0u;
+			} else if (m_slice_tail != m_slice_end) {
+				// The incomplete sequence may be completed by the data
+				--m_slice_size;
+			}
+			m_slice_end = end;
+			count_slice();
+		} else {
+			spill();
+			decode(begin, end);
+		}
+		m_cached = false;
+	}
+
 	/**
 		Compare all characters in the buffer to a character.
 
@@ -166,6 +270,16 @@ public:
 	compare(
 		CharT const c
 	) const noexcept {
+		if (is_slice()) {
+			char32 cp;
+			for (char const* pos = m_slice_begin; m_slice_end != pos;) {
+				pos = decode_one(pos, m_slice_end, cp);
+				if (cp != static_cast<char32>(c)) {
+					return false;
+				}
+			}
+			return true;
+		}
 		for (char_type const x : m_buffer) {
 			if (x != c) {
 				return false;
@@ -187,12 +301,53 @@ public:
 	compare(
 		CharacterSet const& char_set
 	) const noexcept {
-		for (char_type const x : m_buffer) {
-			if (!char_set.contains(x)) {
+		return compare_set(char_set);
+	}
+
+	/** @copydoc compare(CharacterSet const&) const */
+	bool
+	compare(
+		CompiledCharacterSet const& char_set
+	) const noexcept {
+		return compare_set(char_set);
+	}
+
+	/** @copydoc compare(CharacterSet const&) const */
+	bool
+	compare(
+		ASCIICharacterSet const& char_set
+	) const noexcept {
+		return compare_set(char_set);
+	}
+
+	/**
+		Compare buffer to a UTF-8 string.
+
+		@returns @c true if the buffer is equal to the string.
+		@param begin Beginning of string.
+		@param end End of string.
+	*/
+	bool
+	equals(
+		char const* const begin,
+		char const* const end
+	) const noexcept {
+		if (is_slice()) {
+			return
+				m_slice_end - m_slice_begin == end - begin &&
+				std::equal(begin, end, m_slice_begin)
+			;
+		}
+		char32 cp;
+		auto it = m_buffer.cbegin();
+		for (char const* pos = begin; end != pos; ++it) {
+			char const* const next = UTF8Utils::decode(pos, end, cp, CHAR_NULL);
+			if (next == pos || m_buffer.cend() == it || *it != cp) {
 				return false;
 			}
+			pos = next;
 		}
-		return true;
+		return m_buffer.cend() == it;
 	}
 /// @}
 
@@ -213,9 +368,7 @@ public:
 	StringT
 	to_string() const {
 		StringT str;
-		StringUtils::convert<UTF32Utils>(
-			str, m_buffer.cbegin(), m_buffer.cend(), true
-		);
+		to_string(str, true);
 		return str;
 	}
 
@@ -251,9 +404,15 @@ public:
 		StringT& str,
 		bool const append = false
 	) const {
-		StringUtils::convert<UTF32Utils>(
-			str, m_buffer.cbegin(), m_buffer.cend(), append
-		);
+		if (is_slice()) {
+			StringUtils::convert<UTF8Utils>(
+				str, m_slice_begin, m_slice_end, append
+			);
+		} else {
+			StringUtils::convert<UTF32Utils>(
+				str, m_buffer.cbegin(), m_buffer.cend(), append
+			);
+		}
 	}
 
 	/**
@@ -262,6 +421,15 @@ public:
 		@note @a value is guaranteed to be equal to @c T() if
 		extraction failed.
 
+		@note Integral and floating-point types (except @c bool and
+		character types, which are extracted by an
+		@c aux::istringstream) are parsed directly, regardless of the
+		current locale. The entire buffer must be a number: integers
+		must match <code>[+\-]?[0-9]+</code> and floating-point numbers
+		<code>[+\-]?([0-9]+(\.[0-9]*)?|\.[0-9]+)([eE][+\-]?[0-9]+)?</code>.
+		Floating-point values are correctly rounded. A value which
+		overflows @a T is an error; floating-point underflow is not.
+
 		@returns
 		- @c true if the buffer was convertible to @a T (@a value
 		  is set); or
@@ -273,26 +441,21 @@ public:
 	bool
 	to_arithmetic(
 		T& value
-	) {
+	) const {
 		static_assert(
 			std::is_arithmetic<T>::value,
 			"T must be arithmetic"
 		);
-		cache();
-		// FIXME: Clang 3.2 has a defect (with libstdc++ 4.6.3?) in
-		// that it believes the istringstream copy ctor is being used
-		// if aggregate initialization is used here.
-		//
-		// It oddly only occurs when inside of a function template.
-		// GCC 4.6.3 doesn't even care.
-		aux::istringstream stream(m_cache_string);
-		stream >> value;
-		if (stream.fail()) {
+		bool const success = to_arithmetic_impl(
+			value,
+			std::integral_constant<bool,
+				detail::is_parsed_arithmetic<T>::value
+			>{}
+		);
+		if (!success) {
 			value = T();
-			return false;
-		} else {
-			return true;
 		}
+		return success;
 	}
 
 	/**
@@ -304,7 +467,7 @@ public:
 	*/
 	template<class T>
 	T
-	to_arithmetic() {
+	to_arithmetic() const {
 		static_assert(
 			std::is_arithmetic<T>::value,
 			"T must be arithmetic"
@@ -316,6 +479,116 @@ public:
 /// @}
 
 private:
+	template<class SetT>
+	bool
+	compare_set(
+		SetT const& char_set
+	) const noexcept {
+		if (is_slice()) {
+			char32 cp;
+			for (char const* pos = m_slice_begin; m_slice_end != pos;) {
+				pos = decode_one(pos, m_slice_end, cp);
+				if (!char_set.contains(cp)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		for (char_type const x : m_buffer) {
+			if (!char_set.contains(x)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<class T>
+	bool
+	to_arithmetic_impl(
+		T& value,
+		std::true_type
+	) const {
+		if (is_slice()) {
+			return detail::parse_arithmetic(m_slice_begin, m_slice_end, value);
+		} else {
+			return detail::parse_arithmetic(
+				m_buffer.cbegin(), m_buffer.cend(), value
+			);
+		}
+	}
+
+	template<class T>
+	bool
+	to_arithmetic_impl(
+		T& value,
+		std::false_type
+	) const {
+		// FIXME: Clang 3.2 has a defect (with libstdc++ 4.6.3?) in
+		// that it believes the istringstream copy ctor is being used
+		// if aggregate initialization is used here.
+		//
+		// It oddly only occurs when inside of a function template.
+		// GCC 4.6.3 doesn't even care.
+		aux::istringstream stream(to_string<u8string>());
+		stream >> value;
+		return !stream.fail();
+	}
+
+	void spill() {
+		if (is_slice()) {
+			char const* const begin = m_slice_begin;
+			char const* const end = m_slice_end;
+			m_slice_begin = m_slice_end = m_slice_tail = nullptr;
+			m_slice_size = 0u;
+			decode(begin, end);
+		}
+	}
+
+	// Decode a code point; an incomplete sequence is decoded as
+	// CHAR_REPLACEMENT and consumes the rest of the data
+	static char const*
+	decode_one(
+		char const* const pos,
+		char const* const end,
+		char32& cp
+	) noexcept {
+		char const* const next = UTF8Utils::decode(pos, end, cp, CHAR_NULL);
+		if (next == pos) {
+			cp = CHAR_REPLACEMENT;
+			return end;
+		}
+		return next;
+	}
+
+	// Count the code points from the slice's tail to its end
+	void
+	count_slice() noexcept {
+		char32 cp;
+		char const* pos = m_slice_tail;
+		while (m_slice_end != pos) {
+			char const* const next = UTF8Utils::decode(pos, m_slice_end, cp, CHAR_NULL);
+			++m_slice_size;
+			if (next == pos) {
+				m_slice_tail = pos;
+				return;
+			}
+			pos = next;
+		}
+		m_slice_tail = m_slice_end;
+	}
+
+	void decode(
+		char const* pos,
+		char const* const end
+	) {
+		char32 cp;
+		while (end != pos) {
+			pos = decode_one(pos, end, cp);
+			grow();
+			m_buffer.push_back(cp);
+		}
+	}
+
 	void grow() {
 		if (0 == capacity()) {
 			m_buffer.reserve(64u);
@@ -0,0 +1,531 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief CompiledCharacterSet and ASCIICharacterSet.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./aux.hpp"
+#include "./char.hpp"
+#include "./string.hpp"
+#include "./detail/string_traits.hpp"
+#include "./CharacterRange.hpp"
+#include "./CharacterSet.hpp"
+
+#include <cstdint>
+#include <algorithm>
+
+namespace duct {
+
+// Forward declarations
+class ASCIICharacterSet;
+class CompiledCharacterSet;
+
+/**
+	@addtogroup text
+	@{
+*/
+
+/**
+	Constant ASCII character set.
+
+	@note This is a literal type: sets can be built at compile time.
+	Only code points below @c 0x80 can be members; all others are
+	ignored when constructing and never contained.
+*/
+class ASCIICharacterSet final {
+private:
+	std::uint64_t m_low;
+	std::uint64_t m_high;
+
+	// std::min() and std::max() are not constexpr in C++11
+	static constexpr unsigned
+	min_unit(
+		unsigned const a,
+		unsigned const b
+	) noexcept {
+		return (a < b) ? a : b;
+	}
+
+	static constexpr unsigned
+	max_unit(
+		unsigned const a,
+		unsigned const b
+	) noexcept {
+		return (a < b) ? b : a;
+	}
+
+	static constexpr std::uint64_t
+	word_mask(
+		unsigned const first,
+		unsigned const last,
+		unsigned const base
+	) noexcept {
+		return (last < base || first > base + 63u || first > last)
+			? std::uint64_t{0u}
+			: (
+				(
+					(min_unit(last, base + 63u) - base == 63u)
+					? ~std::uint64_t{0u}
+					: (std::uint64_t{1u} << (min_unit(last, base + 63u) - base + 1u))
+					- 1u
+				)
+				& ~(
+					(std::uint64_t{1u} << (max_unit(first, base) - base)) - 1u
+				)
+			)
+		;
+	}
+
+	static constexpr std::uint64_t
+	range_mask(
+		unsigned const a,
+		unsigned const b,
+		unsigned const base
+	) noexcept {
+		return (0x80u > min_unit(a, b))
+			? word_mask(min_unit(a, b), min_unit(max_unit(a, b), 0x7Fu), base)
+			: std::uint64_t{0u}
+		;
+	}
+
+	static constexpr unsigned
+	unit(
+		char const* const str
+	) noexcept {
+		return static_cast<unsigned char>(*str);
+	}
+
+	// Position of the (possibly escaped) unit at str
+	static constexpr char const*
+	unescape(
+		char const* const str
+	) noexcept {
+		return ('\\' == str[0] && '\0' != str[1]) ? str + 1 : str;
+	}
+
+	// Whether no unit is left at str (a trailing escape has none)
+	static constexpr bool
+	at_end(
+		char const* const str
+	) noexcept {
+		return '\0' == str[0] || ('\\' == str[0] && '\0' == str[1]);
+	}
+
+	static constexpr std::uint64_t
+	string_mask(
+		char const* const str,
+		unsigned const base
+	) noexcept {
+		return at_end(str)
+			? std::uint64_t{0u}
+			: string_mask_item(unescape(str), base)
+		;
+	}
+
+	// As in CharacterSet::add_from_string(), an incomplete range at
+	// the end adds only its first unit
+	static constexpr std::uint64_t
+	string_mask_item(
+		char const* const str,
+		unsigned const base
+	) noexcept {
+		return ('-' != str[1])
+			? range_mask(unit(str), unit(str), base)
+				| string_mask(str + 1, base)
+		: at_end(str + 2)
+			? range_mask(unit(str), unit(str), base)
+			: range_mask(unit(str), unit(unescape(str + 2)), base)
+				| string_mask(unescape(str + 2) + 1, base)
+		;
+	}
+
+	constexpr
+	ASCIICharacterSet(
+		std::uint64_t const low,
+		std::uint64_t const high
+	) noexcept
+		: m_low(low)
+		, m_high(high)
+	{}
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Construct empty set. */
+	constexpr
+	ASCIICharacterSet() noexcept
+		: m_low(0u)
+		, m_high(0u)
+	{}
+
+	/**
+		Construct with string ranges.
+
+		@note The syntax is that of CharacterSet::add_from_string(),
+		but units are not decoded; multi-unit sequences are ignored.
+		As with CharacterSet, the dash of an incomplete range at the
+		end (such as @c "a-") is not a member.
+
+		@param str String of ranges.
+	*/
+	explicit constexpr
+	ASCIICharacterSet(
+		char const* const str
+	) noexcept
+		: m_low(string_mask(str, 0u))
+		, m_high(string_mask(str, 64u))
+	{}
+
+	/**
+		Construct with single range.
+
+		@param first First code point of range.
+		@param length Number of code points in the range (after
+		@a first).
+	*/
+	constexpr
+	ASCIICharacterSet(
+		char32 const first,
+		unsigned const length
+	) noexcept
+		: m_low((0x80u > first)
+			? range_mask(first, first + min_unit(length, 0x7Fu), 0u)
+			: std::uint64_t{0u}
+		)
+		, m_high((0x80u > first)
+			? range_mask(first, first + min_unit(length, 0x7Fu), 64u)
+			: std::uint64_t{0u}
+		)
+	{}
+
+	/** Copy constructor. */
+	constexpr ASCIICharacterSet(ASCIICharacterSet const&) = default;
+	/** Move constructor. */
+	constexpr ASCIICharacterSet(ASCIICharacterSet&&) = default;
+	/** Destructor. */
+	~ASCIICharacterSet() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	ASCIICharacterSet& operator=(ASCIICharacterSet const&) = default;
+	/** Move assignment operator. */
+	ASCIICharacterSet& operator=(ASCIICharacterSet&&) = default;
+
+	/**
+		Union operator.
+
+		@returns The union of @c *this and @a other.
+		@param other Set to unite with.
+	*/
+	constexpr ASCIICharacterSet
+	operator|(
+		ASCIICharacterSet const& other
+	) const noexcept {
+		return ASCIICharacterSet{m_low | other.m_low, m_high | other.m_high};
+	}
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Check if the set is empty.
+	*/
+	constexpr bool
+	empty() const noexcept {
+		return 0u == m_low && 0u == m_high;
+	}
+/// @}
+
+/** @name Comparison */ /// @{
+	/**
+		Check if the set contains a code point.
+
+		@returns
+		- @c true if @a cp is contained, or
+		- @c false if it was not.
+		@param cp Code point to test.
+	*/
+	constexpr bool
+	contains(
+		char32 const cp
+	) const noexcept {
+		return
+			0x80u > cp &&
+			0u != (((0x40u > cp) ? m_low : m_high) >> (cp & 0x3Fu) & 1u)
+		;
+	}
+/// @}
+
+/** @name Modification */ /// @{
+	/**
+		Add a length range.
+
+		@returns @c *this.
+		@param first Start of the range.
+		@param length Length of the range.
+	*/
+	ASCIICharacterSet&
+	add_range(
+		char32 const first,
+		unsigned const length = 0
+	) noexcept {
+		return *this = *this | ASCIICharacterSet{first, length};
+	}
+/// @}
+};
+
+/**
+	Compiled character set.
+
+	@note The ranges of the source set are sorted and merged into
+	canonical (disjoint, non-adjacent) ranges. ASCII membership is
+	answered by a bitmap and all other code points by binary search
+	over the canonical ranges.
+*/
+class CompiledCharacterSet final {
+public:
+/** @name Types */ /// @{
+	/** CharacterRange vector. */
+	using vector_type = duct::aux::vector<CharacterRange>;
+	/** CharacterRange iterator. */
+	using const_iterator = vector_type::const_iterator;
+/// @}
+
+private:
+	ASCIICharacterSet m_ascii{};
+	vector_type m_ranges{};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Construct empty set. */
+	CompiledCharacterSet() = default;
+
+	/**
+		Construct with CharacterSet.
+
+		@param set Set to compile.
+	*/
+	explicit
+	CompiledCharacterSet(
+		CharacterSet const& set
+	) {
+		compile(set);
+	}
+
+	/**
+		Construct with string ranges.
+
+		@param str String of ranges.
+		@sa CharacterSet::add_from_string()
+	*/
+	explicit
+	CompiledCharacterSet(
+		u8string const& str
+	) {
+		compile(CharacterSet{str});
+	}
+
+	/** @copydoc CompiledCharacterSet(u8string const&) */
+	explicit
+	CompiledCharacterSet(
+		char const* const str
+	) {
+		compile(CharacterSet{str});
+	}
+
+	/** Copy constructor. */
+	CompiledCharacterSet(CompiledCharacterSet const&) = default;
+	/** Move constructor. */
+	CompiledCharacterSet(CompiledCharacterSet&&) = default;
+	/** Destructor. */
+	~CompiledCharacterSet() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	CompiledCharacterSet& operator=(CompiledCharacterSet const&) = default;
+	/** Move assignment operator. */
+	CompiledCharacterSet& operator=(CompiledCharacterSet&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get ASCII bitmap.
+	*/
+	ASCIICharacterSet const&
+	ascii() const noexcept {
+		return m_ascii;
+	}
+
+	/**
+		Get number of canonical ranges.
+	*/
+	vector_type::size_type
+	size() const noexcept {
+		return m_ranges.size();
+	}
+
+	/**
+		Get beginning canonical range iterator.
+
+		@note Ranges are sorted by their first code point.
+	*/
+	const_iterator
+	cbegin() const noexcept {
+		return m_ranges.cbegin();
+	}
+
+	/**
+		Get ending canonical range iterator.
+	*/
+	const_iterator
+	cend() const noexcept {
+		return m_ranges.cend();
+	}
+/// @}
+
+/** @name Comparison */ /// @{
+	/**
+		Check if the set contains a code point.
+
+		@returns
+		- @c true if @a cp is contained, or
+		- @c false if it was not.
+		@param cp Code point to test.
+	*/
+	bool
+	contains(
+		char32 const cp
+	) const noexcept {
+		if (0x80u > cp) {
+			return m_ascii.contains(cp);
+		}
+		// First range starting after cp; its predecessor is the only
+		// candidate
+		auto const it = std::upper_bound(
+			m_ranges.cbegin(), m_ranges.cend(), cp,
+			[](char32 const x, CharacterRange const& r) {
+				return x < r.first();
+			}
+		);
+		return m_ranges.cbegin() != it && (it - 1)->contains(cp);
+	}
+
+	/** @copydoc CharacterRange::sequence_find(InputIt,InputIt const) const */
+	template<class StringU, class InputIt>
+	InputIt
+	sequence_find(
+		InputIt pos,
+		InputIt const end
+	) const noexcept {
+		char32 cp;
+		InputIt next;
+		for (; end != pos; pos = next) {
+			next = StringU::decode(pos, end, cp, CHAR_SENTINEL);
+			if (next == pos) { // Incomplete sequence
+				return end;
+			} else if (CHAR_SENTINEL != cp && contains(cp)) {
+				return pos;
+			}
+		}
+		return end;
+	}
+
+	/** @copydoc CharacterRange::find(StringT const&,StringI) const */
+	template<
+		class StringT,
+		class StringU = typename detail::string_traits<StringT>::encoding_utils,
+		class StringI = typename StringT::const_iterator
+	>
+	StringI
+	find(
+		StringT const& str,
+		StringI pos
+	) const noexcept {
+		return sequence_find<StringU>(pos, str.cend());
+	}
+
+	/** @copydoc CharacterRange::sequence_matches(InputIt,InputIt const) const */
+	template<class StringU, class InputIt>
+	bool
+	sequence_matches(
+		InputIt pos,
+		InputIt const end
+	) const noexcept {
+		char32 cp;
+		InputIt next;
+		for (; end != pos; pos = next) {
+			next = StringU::decode(pos, end, cp, CHAR_SENTINEL);
+			// Incomplete sequence || bad sequence || not a match
+			if (next == pos || CHAR_SENTINEL == cp || !contains(cp)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** @copydoc CharacterRange::matches(StringT const&,StringI) const */
+	template<
+		class StringT,
+		class StringU = typename detail::string_traits<StringT>::encoding_utils,
+		class StringI = typename StringT::const_iterator
+	>
+	bool
+	matches(
+		StringT const& str,
+		StringI pos
+	) const noexcept {
+		return sequence_matches<StringU>(pos, str.cend());
+	}
+/// @}
+
+/** @name Modification */ /// @{
+	/**
+		Compile a CharacterSet.
+
+		@note The current ranges are replaced.
+
+		@param set Set to compile.
+	*/
+	void
+	compile(
+		CharacterSet const& set
+	) {
+		m_ascii = ASCIICharacterSet{};
+		m_ranges.assign(set.cbegin(), set.cend());
+		std::sort(
+			m_ranges.begin(), m_ranges.end(),
+			[](CharacterRange const& x, CharacterRange const& y) {
+				return x.first() < y.first();
+			}
+		);
+		// Merge overlapping and adjacent ranges
+		auto out = m_ranges.begin();
+		for (auto it = m_ranges.begin(); m_ranges.end() != it; ++it) {
+			if (m_ranges.begin() != out && (
+				(out - 1)->last() >= it->first() ||
+				(out - 1)->last() + 1u == it->first()
+			)) {
+				if (it->last() > (out - 1)->last()) {
+					(out - 1)->set_last(it->last());
+				}
+			} else {
+				*out++ = *it;
+			}
+		}
+		m_ranges.erase(out, m_ranges.end());
+		for (auto const& r : m_ranges) {
+			if (0x80u > r.first()) {
+				m_ascii.add_range(r.first(), r.last() - r.first());
+			}
+		}
+	}
+/// @}
+};
+
+/** @} */ // end of doc-group text
+
+} // namespace duct
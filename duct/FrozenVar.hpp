@@ -0,0 +1,681 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief FrozenVar class.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./aux.hpp"
+#include "./string.hpp"
+#include "./debug.hpp"
+#include "./detail/var.hpp"
+#include "./detail/hash.hpp"
+#include "./VarType.hpp"
+#include "./Var.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <unordered_map>
+
+namespace duct {
+
+// Forward declarations
+class FrozenVar;
+
+/**
+	@addtogroup var
+	@{
+*/
+
+/**
+	Read-only, flattened Var tree.
+
+	All variables are stored in a single buffer in breadth-first
+	order, so the children of each collection are contiguous and
+	referenced by index range. Names and string values are stored
+	(once each) in a single string blob.
+
+	Variables are accessed through Ref, which has the const part of
+	Var's interface. A Ref is valid as long as its FrozenVar.
+
+	@note A FrozenVar is never modified after construction, so it can
+	be read from multiple threads without synchronization.
+*/
+class FrozenVar final {
+public:
+/** @name Types */ /// @{
+	/** Reference to a string in the string blob. */
+	struct StringRef final {
+		/** String data (NUL-terminated). */
+		char const* data;
+		/** Size in bytes. */
+		std::size_t size;
+
+		/** Get as u8string. */
+		u8string
+		str() const {
+			return u8string(data, size);
+		}
+
+		/** Check if empty. */
+		bool
+		empty() const noexcept {
+			return 0u == size;
+		}
+
+		/** Equality operator. */
+		bool
+		operator==(
+			StringRef const& other
+		) const noexcept {
+			return
+				size == other.size &&
+				0 == std::memcmp(data, other.data, size)
+			;
+		}
+
+		/** Equality operator. */
+		bool
+		operator==(
+			u8string const& other
+		) const noexcept {
+			return
+				size == other.size() &&
+				0 == std::memcmp(data, other.data(), size)
+			;
+		}
+
+		/** Equality operator. */
+		bool
+		operator==(
+			char const* const other
+		) const noexcept {
+			return
+				size == std::strlen(other) &&
+				0 == std::memcmp(data, other, size)
+			;
+		}
+
+		/** Inequality operator. */
+		template<class T>
+		bool
+		operator!=(
+			T const& other
+		) const noexcept {
+			return !(*this == other);
+		}
+	};
+
+	class Ref;
+	class const_iterator;
+/// @}
+
+private:
+	struct Node final {
+		std::uint32_t name_offset;
+		std::uint32_t name_size;
+		union {
+			detail::var_config::integer_type integer;
+			detail::var_config::decimal_type decimal;
+			detail::var_config::boolean_type boolean;
+			struct {
+				std::uint32_t offset;
+				std::uint32_t size;
+			} string;
+			struct {
+				std::uint32_t first;
+				std::uint32_t count;
+			} children;
+		};
+		VarType type;
+	};
+
+	// Names and string values are stored once each
+	struct StringTable final {
+		struct Key final {
+			char const* data;
+			std::size_t size;
+
+			bool
+			operator==(
+				Key const& other
+			) const noexcept {
+				return
+					size == other.size &&
+					0 == std::memcmp(data, other.data, size)
+				;
+			}
+		};
+
+		struct KeyHash final {
+			std::size_t
+			operator()(
+				Key const& key
+			) const noexcept {
+				return detail::fnv1a_size(key.data, key.size);
+			}
+		};
+
+		aux::vector<char>& strings;
+		std::unordered_map<Key, std::uint32_t, KeyHash> offsets{};
+
+		explicit
+		StringTable(
+			aux::vector<char>& strings
+		)
+			: strings(strings)
+		{}
+
+		std::uint32_t
+		add(
+			char const* const data,
+			std::size_t const size
+		) {
+			auto const it = offsets.find(Key{data, size});
+			if (offsets.end() != it) {
+				return it->second;
+			}
+			DUCT_ASSERTE(0xFFFFFFFFu > strings.size() + size);
+			auto const offset = static_cast<std::uint32_t>(strings.size());
+			strings.insert(strings.end(), data, data + size);
+			strings.push_back('\0');
+			offsets.emplace(Key{data, size}, offset);
+			return offset;
+		}
+	};
+
+	aux::vector<Node> m_nodes{};
+	aux::vector<char> m_strings{};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/**
+		Construct nameless @c VarType::null.
+	*/
+	FrozenVar()
+		: FrozenVar(Var{})
+	{}
+
+	/**
+		Construct from a variable.
+
+		@param var Variable to freeze. Can be any type.
+	*/
+	explicit
+	FrozenVar(
+		Var const& var
+	);
+
+	/** Copy constructor. */
+	FrozenVar(FrozenVar const&) = default;
+	/** Move constructor. */
+	FrozenVar(FrozenVar&&) = default;
+	/** Destructor. */
+	~FrozenVar() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	FrozenVar& operator=(FrozenVar const&) = default;
+	/** Move assignment operator. */
+	FrozenVar& operator=(FrozenVar&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get root variable.
+	*/
+	Ref
+	root() const noexcept;
+
+	/**
+		Get number of variables.
+	*/
+	std::size_t
+	node_count() const noexcept {
+		return m_nodes.size();
+	}
+
+	/**
+		Get size of the string blob in bytes.
+	*/
+	std::size_t
+	string_size() const noexcept {
+		return m_strings.size();
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Convert to a Var.
+
+		@returns A copy of the frozen tree.
+	*/
+	Var
+	thaw() const;
+/// @}
+};
+
+/**
+	Variable in a FrozenVar.
+
+	@note This is a pointer to a variable; copies are cheap. The
+	default-constructed (and not-found) Ref is invalid, and may only
+	be tested with valid().
+*/
+class FrozenVar::Ref final {
+	friend class FrozenVar;
+	friend class FrozenVar::const_iterator;
+
+private:
+	FrozenVar const* m_frozen{nullptr};
+	Node const* m_node{nullptr};
+
+	Ref(
+		FrozenVar const* const frozen,
+		Node const* const node
+	) noexcept
+		: m_frozen(frozen)
+		, m_node(node)
+	{}
+
+	StringRef
+	string_at(
+		std::uint32_t const offset,
+		std::uint32_t const size
+	) const noexcept {
+		return StringRef{m_frozen->m_strings.data() + offset, size};
+	}
+
+	Node const*
+	children_data() const noexcept {
+		return m_frozen->m_nodes.data() + m_node->children.first;
+	}
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Construct invalid. */
+	Ref() = default;
+	/** Copy constructor. */
+	Ref(Ref const&) = default;
+	/** Destructor. */
+	~Ref() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	Ref& operator=(Ref const&) = default;
+
+	/** Equality operator (identity). */
+	bool
+	operator==(
+		Ref const& other
+	) const noexcept {
+		return m_node == other.m_node;
+	}
+
+	/** Inequality operator (identity). */
+	bool
+	operator!=(
+		Ref const& other
+	) const noexcept {
+		return m_node != other.m_node;
+	}
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Check if the reference is valid.
+	*/
+	bool
+	valid() const noexcept {
+		return nullptr != m_node;
+	}
+
+	/** @copydoc Var::type() const */
+	VarType
+	type() const noexcept {
+		return m_node->type;
+	}
+
+	/** @copydoc Var::name() const */
+	StringRef
+	name() const noexcept {
+		return string_at(m_node->name_offset, m_node->name_size);
+	}
+
+	/** @copydoc Var::is_type(VarType const) const */
+	bool
+	is_type(
+		VarType const type
+	) const noexcept {
+		return type == m_node->type;
+	}
+
+	/** @copydoc Var::is_type_of(VarMask const) const */
+	bool
+	is_type_of(
+		VarMask const mask
+	) const noexcept {
+		return var_type_is_of(m_node->type, mask);
+	}
+
+	/** @copydoc Var::is_null() const */
+	bool
+	is_null() const noexcept {
+		return VarType::null == m_node->type;
+	}
+/// @}
+
+/** @name Values */ /// @{
+	/** @copydoc Var::string() const */
+	u8string
+	string() const {
+		return string_ref().str();
+	}
+
+	/** @copydoc Var::string() const */
+	StringRef
+	string_ref() const noexcept {
+		DUCT_ASSERTE(VarType::string == m_node->type);
+		return string_at(m_node->string.offset, m_node->string.size);
+	}
+
+	/** @copydoc Var::integer() const */
+	detail::var_config::integer_type
+	integer() const noexcept {
+		DUCT_ASSERTE(VarType::integer == m_node->type);
+		return m_node->integer;
+	}
+
+	/** @copydoc Var::decimal() const */
+	detail::var_config::decimal_type
+	decimal() const noexcept {
+		DUCT_ASSERTE(VarType::decimal == m_node->type);
+		return m_node->decimal;
+	}
+
+	/** @copydoc Var::boolean() const */
+	detail::var_config::boolean_type
+	boolean() const noexcept {
+		DUCT_ASSERTE(VarType::boolean == m_node->type);
+		return m_node->boolean;
+	}
+/// @}
+
+/** @name Children */ /// @{
+	/** Get beginning child iterator. */
+	const_iterator
+	begin() const noexcept;
+
+	/** Get ending child iterator. */
+	const_iterator
+	end() const noexcept;
+
+	/** @copydoc Var::empty() const */
+	bool
+	empty() const noexcept {
+		DUCT_ASSERTE(is_type_of(VarMask::collection));
+		return 0u == m_node->children.count;
+	}
+
+	/** @copydoc Var::size() const */
+	std::size_t
+	size() const noexcept {
+		DUCT_ASSERTE(is_type_of(VarMask::collection));
+		return m_node->children.count;
+	}
+
+	/** @copydoc Var::front() const */
+	Ref
+	front() const noexcept {
+		return at(0u);
+	}
+
+	/** @copydoc Var::back() const */
+	Ref
+	back() const noexcept {
+		return at(size() - 1u);
+	}
+
+	/**
+		Get child at index.
+
+		@param index Child index.
+	*/
+	Ref
+	at(
+		std::size_t const index
+	) const noexcept {
+		DUCT_ASSERTE(size() > index);
+		return Ref{m_frozen, children_data() + index};
+	}
+
+	/**
+		Find the first child with a name.
+
+		@note Children are searched linearly. They are contiguous, so
+		this is fast for the sizes of typical collections.
+
+		@returns The first child named @a name, or an invalid Ref if
+		there is none.
+		@param name Name to find.
+	*/
+	Ref
+	find(
+		u8string const& name
+	) const noexcept {
+		DUCT_ASSERTE(is_type_of(VarMask::collection));
+		char const* const strings = m_frozen->m_strings.data();
+		Node const* const first = children_data();
+		Node const* const last = first + m_node->children.count;
+		for (Node const* node = first; last != node; ++node) {
+			if (
+				name.size() == node->name_size &&
+				0 == std::memcmp(strings + node->name_offset, name.data(), name.size())
+			) {
+				return Ref{m_frozen, node};
+			}
+		}
+		return Ref{};
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Convert to a Var.
+
+		@returns A copy of this variable.
+	*/
+	Var
+	to_var() const;
+/// @}
+};
+
+/**
+	FrozenVar child iterator.
+*/
+class FrozenVar::const_iterator final {
+	friend class FrozenVar::Ref;
+
+private:
+	FrozenVar const* m_frozen{nullptr};
+	Node const* m_node{nullptr};
+
+	const_iterator(
+		FrozenVar const* const frozen,
+		Node const* const node
+	) noexcept
+		: m_frozen(frozen)
+		, m_node(node)
+	{}
+
+public:
+/** @name Types */ /// @{
+	/** Iterator category. */
+	using iterator_category = std::forward_iterator_tag;
+	/** Value type. */
+	using value_type = Ref;
+	/** Difference type. */
+	using difference_type = std::ptrdiff_t;
+	/** Pointer type (not used). */
+	using pointer = void;
+	/** Reference type. */
+	using reference = Ref;
+/// @}
+
+/** @name Constructors and destructor */ /// @{
+	/** Default constructor. */
+	const_iterator() = default;
+	/** Copy constructor. */
+	const_iterator(const_iterator const&) = default;
+	/** Destructor. */
+	~const_iterator() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	const_iterator& operator=(const_iterator const&) = default;
+
+	/** Dereference operator. */
+	Ref
+	operator*() const noexcept {
+		return Ref{m_frozen, m_node};
+	}
+
+	/** Pre-increment operator. */
+	const_iterator&
+	operator++() noexcept {
+		++m_node;
+		return *this;
+	}
+
+	/** Post-increment operator. */
+	const_iterator
+	operator++(int) noexcept {
+		const_iterator const previous{*this};
+		++m_node;
+		return previous;
+	}
+
+	/** Equality operator. */
+	bool
+	operator==(
+		const_iterator const& other
+	) const noexcept {
+		return m_node == other.m_node;
+	}
+
+	/** Inequality operator. */
+	bool
+	operator!=(
+		const_iterator const& other
+	) const noexcept {
+		return m_node != other.m_node;
+	}
+/// @}
+};
+
+/** @} */ // end of doc-group var
+
+inline
+FrozenVar::FrozenVar(
+	Var const& var
+) {
+	StringTable table{m_strings};
+	// Sources in node order; the children of sources[i] are appended
+	// to the node buffer when node i is reached
+	aux::vector<Var const*> sources{};
+	sources.push_back(&var);
+	for (std::size_t i = 0u; sources.size() > i; ++i) {
+		Var const& source = *sources[i];
+		Node node;
+		std::memset(&node, 0, sizeof(Node));
+		auto const& name = source.name();
+		node.name_offset = table.add(name.data(), name.size());
+		node.name_size = static_cast<std::uint32_t>(name.size());
+		node.type = source.type();
+		switch (source.type()) {
+		case VarType::string: {
+			auto const& str = source.string_ref();
+			node.string.offset = table.add(str.data(), str.size());
+			node.string.size = static_cast<std::uint32_t>(str.size());
+		}	break;
+		case VarType::integer: node.integer = source.integer(); break;
+		case VarType::decimal: node.decimal = source.decimal(); break;
+		case VarType::boolean: node.boolean = source.boolean(); break;
+		case VarType::array:
+		case VarType::node:
+		case VarType::identifier:
+			DUCT_ASSERTE(0xFFFFFFFFu > sources.size() + source.size());
+			node.children.first = static_cast<std::uint32_t>(sources.size());
+			node.children.count = static_cast<std::uint32_t>(source.size());
+			for (auto const& child : source) {
+				sources.push_back(&child);
+			}
+			break;
+		default:
+			break;
+		}
+		m_nodes.push_back(node);
+	}
+	m_nodes.shrink_to_fit();
+	m_strings.shrink_to_fit();
+}
+
+inline FrozenVar::Ref
+FrozenVar::root() const noexcept {
+	return Ref{this, m_nodes.data()};
+}
+
+inline Var
+FrozenVar::thaw() const {
+	return root().to_var();
+}
+
+inline FrozenVar::const_iterator
+FrozenVar::Ref::begin() const noexcept {
+	DUCT_ASSERTE(is_type_of(VarMask::collection));
+	return const_iterator{m_frozen, children_data()};
+}
+
+inline FrozenVar::const_iterator
+FrozenVar::Ref::end() const noexcept {
+	DUCT_ASSERTE(is_type_of(VarMask::collection));
+	return const_iterator{m_frozen, children_data() + m_node->children.count};
+}
+
+inline Var
+FrozenVar::Ref::to_var() const {
+	StringRef const name_ref = name();
+	detail::var_config::name_type var_name{u8string(name_ref.data, name_ref.size)};
+	switch (type()) {
+	case VarType::string: return Var{std::move(var_name), string()};
+	case VarType::integer: return Var{std::move(var_name), integer()};
+	case VarType::decimal: return Var{std::move(var_name), decimal()};
+	case VarType::boolean: return Var{std::move(var_name), boolean()};
+	case VarType::array:
+	case VarType::node:
+	case VarType::identifier: {
+		Var var{std::move(var_name), type()};
+		if (!empty()) {
+			auto& children = var.children();
+			children.reserve(size());
+			for (auto const child : *this) {
+				children.push_back(child.to_var());
+			}
+		}
+		return var;
+	}
+	default:
+		return Var{std::move(var_name), VarType::null};
+	}
+}
+
+} // namespace duct
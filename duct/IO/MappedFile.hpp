@@ -0,0 +1,304 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief MappedFile class.
+*/
+
+#pragma once
+
+#include "../config.hpp"
+#include "../string.hpp"
+
+#include <cstddef>
+#include <utility>
+
+#if defined(DUCT_PLATFORM_SYSTEM_WINDOWS)
+	// Keep min()/max() and the rarely used APIs out of users' code
+	#if !defined(NOMINMAX)
+		#define NOMINMAX
+		#define DUCT_IO_MAPPEDFILE_NOMINMAX_
+	#endif
+	#if !defined(WIN32_LEAN_AND_MEAN)
+		#define WIN32_LEAN_AND_MEAN
+		#define DUCT_IO_MAPPEDFILE_LEAN_AND_MEAN_
+	#endif
+	#include <windows.h>
+	#if defined(DUCT_IO_MAPPEDFILE_NOMINMAX_)
+		#undef NOMINMAX
+		#undef DUCT_IO_MAPPEDFILE_NOMINMAX_
+	#endif
+	#if defined(DUCT_IO_MAPPEDFILE_LEAN_AND_MEAN_)
+		#undef WIN32_LEAN_AND_MEAN
+		#undef DUCT_IO_MAPPEDFILE_LEAN_AND_MEAN_
+	#endif
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace duct {
+namespace IO {
+
+// Forward declarations
+class MappedFile;
+
+/**
+	@addtogroup io
+	@{
+*/
+
+/**
+	Read-only memory-mapped file.
+
+	@note The mapping is hinted for sequential access. An empty file
+	is considered open, but has no data.
+*/
+class MappedFile final {
+private:
+	char const* m_data{nullptr};
+	std::size_t m_size{0u};
+	bool m_open{false};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Construct closed. */
+	MappedFile() = default;
+
+	/**
+		Construct with path.
+
+		@param path Path of file to map.
+		@sa open(char const*)
+	*/
+	explicit
+	MappedFile(
+		char const* const path
+	) {
+		open(path);
+	}
+
+	/** Copy constructor (deleted). */
+	MappedFile(MappedFile const&) = delete;
+
+	/** Move constructor. */
+	MappedFile(
+		MappedFile&& other
+	) noexcept
+		: m_data(other.m_data)
+		, m_size(other.m_size)
+		, m_open(other.m_open)
+	{
+		other.m_data = nullptr;
+		other.m_size = 0u;
+		other.m_open = false;
+	}
+
+	/** Destructor. */
+	~MappedFile() {
+		close();
+	}
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	/** Move assignment operator. */
+	MappedFile&
+	operator=(
+		MappedFile&& other
+	) noexcept {
+		if (this != &other) {
+			close();
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+			std::swap(m_open, other.m_open);
+		}
+		return *this;
+	}
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Check if a file is mapped.
+	*/
+	bool
+	is_open() const noexcept {
+		return m_open;
+	}
+
+	/**
+		Get mapped data.
+
+		@returns The mapped data (@c nullptr if the file is empty
+		or closed).
+	*/
+	char const*
+	data() const noexcept {
+		return m_data;
+	}
+
+	/**
+		Get size.
+
+		@returns The size of the mapped data in bytes.
+	*/
+	std::size_t
+	size() const noexcept {
+		return m_size;
+	}
+
+	/**
+		Get beginning of mapped data.
+	*/
+	char const*
+	begin() const noexcept {
+		return m_data;
+	}
+
+	/**
+		Get end of mapped data.
+	*/
+	char const*
+	end() const noexcept {
+		return m_data + m_size;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Map a file.
+
+		@note The currently mapped file is closed.
+
+		@returns @c true if the file was mapped.
+		@param path Path of file to map.
+	*/
+	bool
+	open(
+		char const* const path
+	);
+
+	/** @copydoc open(char const*) */
+	bool
+	open(
+		u8string const& path
+	) {
+		return open(path.c_str());
+	}
+
+	/**
+		Unmap the file.
+	*/
+	void
+	close() noexcept;
+/// @}
+};
+
+/** @} */ // end of doc-group io
+
+#if defined(DUCT_PLATFORM_SYSTEM_WINDOWS)
+
+inline bool
+MappedFile::open(
+	char const* const path
+) {
+	close();
+	HANDLE const file = ::CreateFileA(
+		path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+	);
+	if (INVALID_HANDLE_VALUE == file) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!::GetFileSizeEx(file, &size)) {
+		::CloseHandle(file);
+		return false;
+	} else if (0 == size.QuadPart) {
+		::CloseHandle(file);
+		m_open = true;
+		return true;
+	}
+	HANDLE const mapping = ::CreateFileMappingA(
+		file, nullptr, PAGE_READONLY, 0, 0, nullptr
+	);
+	::CloseHandle(file);
+	if (nullptr == mapping) {
+		return false;
+	}
+	void const* const view = ::MapViewOfFile(
+		mapping, FILE_MAP_READ, 0, 0, 0
+	);
+	// The view keeps the mapping alive
+	::CloseHandle(mapping);
+	if (nullptr == view) {
+		return false;
+	}
+	m_data = static_cast<char const*>(view);
+	m_size = static_cast<std::size_t>(size.QuadPart);
+	m_open = true;
+	return true;
+}
+
+inline void
+MappedFile::close() noexcept {
+	if (nullptr != m_data) {
+		::UnmapViewOfFile(m_data);
+	}
+	m_data = nullptr;
+	m_size = 0u;
+	m_open = false;
+}
+
+#else
+
+inline bool
+MappedFile::open(
+	char const* const path
+) {
+	close();
+	signed const fd = ::open(path, O_RDONLY);
+	if (-1 == fd) {
+		return false;
+	}
+	struct ::stat info;
+	if (0 != ::fstat(fd, &info)) {
+		::close(fd);
+		return false;
+	} else if (0 == info.st_size) {
+		::close(fd);
+		m_open = true;
+		return true;
+	}
+	std::size_t const size = static_cast<std::size_t>(info.st_size);
+	void* const addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps the file alive
+	::close(fd);
+	if (MAP_FAILED == addr) {
+		return false;
+	}
+	::madvise(addr, size, MADV_SEQUENTIAL);
+	m_data = static_cast<char const*>(addr);
+	m_size = size;
+	m_open = true;
+	return true;
+}
+
+inline void
+MappedFile::close() noexcept {
+	if (nullptr != m_data) {
+		::munmap(const_cast<char*>(m_data), m_size);
+	}
+	m_data = nullptr;
+	m_size = 0u;
+	m_open = false;
+}
+
+#endif
+
+} // namespace IO
+} // namespace duct
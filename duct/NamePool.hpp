@@ -0,0 +1,439 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief NamePool and InternedName classes.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./aux.hpp"
+#include "./string.hpp"
+#include "./Arena.hpp"
+#include "./detail/hash.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+
+namespace duct {
+
+// Forward declarations
+class NamePool;
+class InternedName;
+
+/**
+	@addtogroup var
+	@{
+*/
+
+/**
+	Interned string pool.
+
+	@note Strings are only ever added to the pool, so references to
+	pooled strings are valid for the lifetime of the pool. Equal
+	strings are pooled once, so two pooled strings are equal iff they
+	are the same object.
+
+	@note Interning is thread-safe. The pool is split into shards by
+	hash, each with its own lock, so threads interning different
+	names rarely wait on each other.
+
+	@sa InternedName
+*/
+class NamePool final {
+private:
+	enum : std::size_t {
+		shard_count = 16u,
+		initial_slot_count = 64u
+	};
+
+	// Strings are stored in a deque so that they never move; slots
+	// index them by open addressing (linear probing)
+	struct Shard final {
+		std::mutex mutex{};
+		aux::deque<u8string> names{};
+		aux::vector<u8string const*> slots{};
+	};
+
+	Shard m_shards[shard_count]{};
+
+	// Pooled strings outlive any arena
+	explicit
+	NamePool(
+		Arena::Scope const&
+	)
+	{}
+
+	static void
+	grow(
+		Shard& shard
+	);
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Default constructor. */
+	NamePool()
+		: NamePool(Arena::Scope{nullptr})
+	{}
+	/** Copy constructor (deleted). */
+	NamePool(NamePool const&) = delete;
+	/** Destructor. */
+	~NamePool() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	NamePool& operator=(NamePool const&) = delete;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get the shared pool.
+
+		@note This is the pool used by InternedName.
+	*/
+	static NamePool&
+	shared() {
+		static NamePool s_pool{};
+		return s_pool;
+	}
+
+	/**
+		Get the empty string.
+
+		@note The empty string is not stored in the pool; interning an
+		empty string returns this.
+	*/
+	static u8string const&
+	empty_string() noexcept {
+		static u8string const s_empty{};
+		return s_empty;
+	}
+
+	/**
+		Get number of pooled strings.
+	*/
+	std::size_t
+	size() {
+		std::size_t count = 0u;
+		for (auto& shard : m_shards) {
+			std::lock_guard<std::mutex> const lock{shard.mutex};
+			count += shard.names.size();
+		}
+		return count;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Intern a string.
+
+		@returns The pooled string equal to the given string.
+		@param data String data.
+		@param size Size of @a data in bytes.
+	*/
+	u8string const&
+	intern(
+		char const* const data,
+		std::size_t const size
+	);
+
+	/** @copydoc intern(char const*, std::size_t) */
+	u8string const&
+	intern(
+		u8string const& str
+	) {
+		return intern(str.data(), str.size());
+	}
+/// @}
+};
+
+/**
+	Interned name.
+
+	@note This is a pointer to a string in the shared NamePool, so
+	copies are cheap and equal names share storage. Comparing two
+	interned names for equality is a pointer comparison.
+
+	@note This is Var's name type with #DUCT_CONFIG_VAR_INTERN_NAMES.
+	It is implicitly constructible from and convertible to u8string.
+*/
+class InternedName final {
+private:
+	u8string const* m_str;
+
+public:
+/** @name Types */ /// @{
+	/** Iterator type. */
+	using const_iterator = u8string::const_iterator;
+/// @}
+
+/** @name Constructors and destructor */ /// @{
+	/** Construct empty. */
+	InternedName() noexcept
+		: m_str(&NamePool::empty_string())
+	{}
+
+	/**
+		Construct with string.
+
+		@param data String data.
+		@param size Size of @a data in bytes.
+	*/
+	InternedName(
+		char const* const data,
+		std::size_t const size
+	)
+		: m_str(&NamePool::shared().intern(data, size))
+	{}
+
+	/**
+		Construct with string.
+
+		@param str C-string.
+	*/
+	InternedName(
+		char const* const str
+	)
+		: InternedName(str, std::strlen(str))
+	{}
+
+	/**
+		Construct with string.
+
+		@param str String.
+	*/
+	InternedName(
+		u8string const& str
+	)
+		: InternedName(str.data(), str.size())
+	{}
+
+	/** Copy constructor. */
+	InternedName(InternedName const&) noexcept = default;
+	/** Destructor. */
+	~InternedName() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	InternedName& operator=(InternedName const&) noexcept = default;
+
+	/** Get string. */
+	operator u8string const&() const noexcept {
+		return *m_str;
+	}
+
+	/** Equality operator (pointer comparison). */
+	bool
+	operator==(
+		InternedName const& other
+	) const noexcept {
+		return m_str == other.m_str;
+	}
+
+	/** Inequality operator (pointer comparison). */
+	bool
+	operator!=(
+		InternedName const& other
+	) const noexcept {
+		return m_str != other.m_str;
+	}
+
+	/** Equality operator. */
+	bool
+	operator==(
+		char const* const str
+	) const noexcept {
+		return 0 == m_str->compare(str);
+	}
+
+	/** Inequality operator. */
+	bool
+	operator!=(
+		char const* const str
+	) const noexcept {
+		return 0 != m_str->compare(str);
+	}
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get string.
+	*/
+	u8string const&
+	str() const noexcept {
+		return *m_str;
+	}
+
+	/** Get string data. */
+	char const*
+	data() const noexcept {
+		return m_str->data();
+	}
+
+	/** Get C-string. */
+	char const*
+	c_str() const noexcept {
+		return m_str->c_str();
+	}
+
+	/** Get size in bytes. */
+	std::size_t
+	size() const noexcept {
+		return m_str->size();
+	}
+
+	/** Check if empty. */
+	bool
+	empty() const noexcept {
+		return m_str->empty();
+	}
+
+	/** Get beginning iterator. */
+	const_iterator
+	cbegin() const noexcept {
+		return m_str->cbegin();
+	}
+
+	/** Get end iterator. */
+	const_iterator
+	cend() const noexcept {
+		return m_str->cend();
+	}
+
+	/** @copydoc cbegin() */
+	const_iterator
+	begin() const noexcept {
+		return m_str->cbegin();
+	}
+
+	/** @copydoc cend() */
+	const_iterator
+	end() const noexcept {
+		return m_str->cend();
+	}
+/// @}
+
+/** @name Comparison */ /// @{
+	/**
+		Compare to another name.
+
+		@note Equal names are detected by pointer.
+
+		@returns @c 0 if equal, or as @c u8string::compare() otherwise.
+		@param other Name to compare against.
+	*/
+	signed
+	compare(
+		InternedName const& other
+	) const noexcept {
+		return (m_str == other.m_str) ? 0 : m_str->compare(*other.m_str);
+	}
+/// @}
+};
+
+/** Equality operator. */
+inline bool
+operator==(
+	InternedName const& x,
+	u8string const& y
+) noexcept {
+	return x.str() == y;
+}
+
+/** Equality operator. */
+inline bool
+operator==(
+	u8string const& x,
+	InternedName const& y
+) noexcept {
+	return x == y.str();
+}
+
+/** Inequality operator. */
+inline bool
+operator!=(
+	InternedName const& x,
+	u8string const& y
+) noexcept {
+	return x.str() != y;
+}
+
+/** Inequality operator. */
+inline bool
+operator!=(
+	u8string const& x,
+	InternedName const& y
+) noexcept {
+	return x != y.str();
+}
+
+/** Output operator. */
+inline std::ostream&
+operator<<(
+	std::ostream& stream,
+	InternedName const& name
+) {
+	return stream << name.str();
+}
+
+/** @} */ // end of doc-group var
+
+inline void
+NamePool::grow(
+	Shard& shard
+) {
+	std::size_t const slot_count
+		= shard.slots.empty()
+		? std::size_t{initial_slot_count}
+		: shard.slots.size() << 1u
+	;
+	shard.slots.assign(slot_count, nullptr);
+	std::size_t const mask = slot_count - 1u;
+	for (auto const& name : shard.names) {
+		std::size_t i = (detail::fnv1a_size(name.data(), name.size()) / shard_count) & mask;
+		while (nullptr != shard.slots[i]) {
+			i = (i + 1u) & mask;
+		}
+		shard.slots[i] = &name;
+	}
+}
+
+inline u8string const&
+NamePool::intern(
+	char const* const data,
+	std::size_t const size
+) {
+	if (0u == size) {
+		return empty_string();
+	}
+	// Pooled strings outlive any arena
+	Arena::Scope const scope{nullptr};
+	std::size_t const value = detail::fnv1a_size(data, size);
+	Shard& shard = m_shards[value % shard_count];
+	std::lock_guard<std::mutex> const lock{shard.mutex};
+	// Keep the load factor at or below 1/2
+	if (shard.slots.size() <= shard.names.size() << 1u) {
+		grow(shard);
+	}
+	std::size_t const mask = shard.slots.size() - 1u;
+	std::size_t i = (value / shard_count) & mask;
+	for (; nullptr != shard.slots[i]; i = (i + 1u) & mask) {
+		u8string const& name = *shard.slots[i];
+		if (
+			size == name.size() &&
+			0 == std::memcmp(data, name.data(), size)
+		) {
+			return name;
+		}
+	}
+	shard.names.emplace_back(data, size);
+	shard.slots[i] = &shard.names.back();
+	return shard.names.back();
+}
+
+} // namespace duct
@@ -9,11 +9,19 @@
 
 #include "./config.hpp"
 #include "./char.hpp"
+#include "./EndianUtils.hpp"
+#include "./EncodingUtils.hpp"
 #include "./IO/StreamContext.hpp"
 #include "./Token.hpp"
 
+#include <cstddef>
 #include <utility>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <ios>
 #include <istream>
+#include <streambuf>
 
 namespace duct {
 
@@ -29,18 +37,62 @@ class Parser;
 	Base parser class.
 
 	@note This class and deriving classes shall not take ownership of
-	input streams.
+	input streams or source buffers.
+
+	@note Input is read either from a stream (decoded with the
+	encoding and endian of the parser's StreamContext) or from a
+	contiguous UTF-8 source buffer (decoded directly, without touching
+	the StreamContext).
+
+	@note When reading from a source buffer, the line and column are
+	not tracked per code point; they are computed from the source
+	position when they are requested (see line(), column(),
+	token_position() and Token::line()).
 */
 class Parser {
 protected:
-	signed m_line{1}; /**< Line position. */
-	signed m_column{0}; /**< Column position. */
+	/**
+		Stream decoder.
+
+		@note This decodes code points from a stream into a block (see
+		decode_stream_chars()).
+	*/
+	using stream_decoder_type = unsigned (*)(std::istream&, char32*, unsigned);
+
+	enum : unsigned {
+		/** Maximum number of code points decoded from a stream at once. */
+		stream_block_size = 128u
+	};
+
+	mutable signed m_line{1}; /**< Line position (see sync_position()). */
+	mutable signed m_column{0}; /**< Column position (see sync_position()). */
 	char32 m_curchar{CHAR_EOF}; /**< Current code point. */
 	char32 m_peekchar{CHAR_EOF}; /**< Peeked code point. */
 	bool m_peeked{false}; /**< Whether a code point has been peeked. */
 	Token m_token{}; /**< Current token. */
 	std::istream* m_stream{nullptr}; /**< Current stream. */
+	char const* m_source_cur{nullptr}; /**< Source position of current code point. */
+	char const* m_source_pos{nullptr}; /**< Current source position. */
+	char const* m_source_end{nullptr}; /**< End of source buffer. */
 	IO::StreamContext m_stream_ctx{}; /**< Stream context. */
+	stream_decoder_type m_stream_decoder{
+		&decode_stream_chars<UTF8Utils, Endian::system>
+	}; /**< Stream decoder for m_stream_ctx (see initialize()). */
+	/** Decoded stream block (allocated by the first stream initialize()). */
+	std::unique_ptr<char32[]> m_stream_chars{};
+	unsigned m_stream_pos{0u}; /**< Position in m_stream_chars. */
+	unsigned m_stream_size{0u}; /**< Size of m_stream_chars. */
+
+	/** @cond INTERNAL */
+	// Position up to a source position, excluding the code point there
+	mutable char const* m_position_pos{nullptr};
+	mutable signed m_position_line{1};
+	mutable signed m_position_column{0};
+	// Where the position is recomputed from for earlier source positions
+	char const* m_position_base{nullptr};
+	signed m_base_line{1};
+	signed m_base_column{0};
+	/** @endcond */ // INTERNAL
 
 public:
 /** @name Constructor and destructor */ /// @{
@@ -82,6 +134,7 @@ public:
 	*/
 	signed
 	line() const noexcept {
+		sync_position();
 		return m_line;
 	}
 
@@ -92,9 +145,41 @@ public:
 	*/
 	signed
 	column() const noexcept {
+		sync_position();
 		return m_column;
 	}
 
+	/**
+		Get the position of a token.
+
+		@note A token read from a source buffer has a source position
+		(see Token::source()); it is resolved against the current
+		source buffer if it is in it.
+
+		@param token Token.
+		@param[out] line Line position.
+		@param[out] column Column position.
+	*/
+	void
+	token_position(
+		Token const& token,
+		signed& line,
+		signed& column
+	) const noexcept {
+		std::less<char const*> const less{};
+		if (
+			nullptr != token.source() &&
+			nullptr != m_position_pos &&
+			!less(token.source(), m_position_base) &&
+			!less(m_source_end, token.source())
+		) {
+			source_position(token.source(), line, column);
+		} else {
+			line = token.line();
+			column = token.column();
+		}
+	}
+
 	/**
 		Get token.
 
@@ -121,6 +206,17 @@ public:
 		return m_stream;
 	}
 
+	/**
+		Check if the parser is reading from a source buffer.
+
+		@returns @c true if the parser was initialized with a source
+		buffer rather than a stream.
+	*/
+	bool
+	has_source() const noexcept {
+		return nullptr != m_source_end;
+	}
+
 	/**
 		Get stream context.
 
@@ -145,6 +241,11 @@ public:
 		@note This will @c reset() the current state and call @c next_char().
 		@note The input stream is not owned by the parser; its lifetime must
 		be guaranteed by the callee until @c reset() is called.
+		@note The stream decoder is selected from the StreamContext's
+		encoding and endian here, so changes to the StreamContext take
+		effect when the parser is next initialized.
+		@note Code points are decoded in blocks of what the stream has
+		buffered, so the stream may be read past the current code point.
 
 		@returns
 		- @c true if the parser was initialized; or
@@ -159,6 +260,10 @@ public:
 		reset();
 		if (stream.good()) {
 			m_stream = &stream;
+			m_stream_decoder = select_stream_decoder(m_stream_ctx);
+			if (!m_stream_chars) {
+				m_stream_chars.reset(new char32[stream_block_size]);
+			}
 			next_char(); // Get the first character
 			return true;
 		} else {
@@ -166,10 +271,40 @@ public:
 		}
 	}
 
+	/**
+		Initialize with a source buffer.
+
+		@note This will @c reset() the current state and call @c next_char().
+		@note The source buffer is not owned by the parser; its lifetime
+		must be guaranteed by the callee until @c reset() is called.
+		@note The source buffer is always decoded as UTF-8; the parser's
+		StreamContext is not used.
+
+		@returns
+		- @c true if the parser was initialized; or
+		- @c false if an error occurred (in the base implementation: if
+		  @c begin>end).
+		@param begin Beginning of source buffer.
+		@param end End of source buffer.
+	*/
+	virtual bool
+	initialize(
+		char const* const begin,
+		char const* const end
+	) {
+		reset();
+		if (begin <= end) {
+			continue_source(begin, end);
+			return true;
+		} else {
+			return false;
+		}
+	}
+
 	/**
 		Reset all state.
 
-		@note This will nullify the input stream.
+		@note This will nullify the input stream and source buffer.
 		@note The parser's StreamContext is not reset.
 	*/
 	virtual void
@@ -180,10 +315,77 @@ public:
 		m_peeked = false;
 		m_token.reset(NULL_TOKEN, true);
 		m_stream = nullptr;
+		m_stream_pos = m_stream_size = 0u;
+		m_source_cur = nullptr;
+		m_source_pos = nullptr;
+		m_source_end = nullptr;
+		m_position_pos = nullptr;
+		m_position_base = nullptr;
 	}
 /// @}
 
 /** @name Operations */ /// @{
+	/**
+		Continue reading from a source buffer.
+
+		@note Unlike initialize(char const*, char const*), the parser
+		is not reset; the line and column continue from the previous
+		input as if the two inputs were contiguous. The previous input
+		must have been read to its end.
+		@note If the current code point is not @c CHAR_EOF (i.e., it is
+		the last code point of the previous input), it is kept and the
+		first code point of this input is read by the next call to
+		@c next_char(). Otherwise, the first code point is read.
+		@note The previous input must still be valid unless
+		resolve_position() was called after it was read.
+
+		@param begin Beginning of source buffer.
+		@param end End of source buffer.
+	*/
+	void
+	continue_source(
+		char const* const begin,
+		char const* const end
+	) {
+		static char const s_empty[1]{'\0'};
+		DUCT_DEBUG_ASSERTP(
+			begin <= end, this,
+			"Source buffer must not be reversed"
+		);
+		resolve_position();
+		m_source_pos = (nullptr != begin) ? begin : s_empty;
+		m_source_end = (nullptr != begin) ? end : s_empty;
+		// Position after the kept code point
+		if (CHAR_NEWLINE == m_curchar) {
+			set_base(m_source_pos, m_line + 1, 0);
+		} else {
+			set_base(m_source_pos, m_line, m_column);
+		}
+		if (CHAR_EOF == m_curchar) {
+			next_char(); // Get the first character
+		} else {
+			// The kept code point is not in this input
+			m_source_cur = nullptr;
+		}
+	}
+
+	/**
+		Resolve the position from the source buffer.
+
+		@note This sets the line and column of the current position
+		and of the current token, so that they no longer refer to the
+		source buffer. It must be called before the source buffer is
+		released if the position is still needed.
+	*/
+	void
+	resolve_position() noexcept {
+		if (nullptr != m_position_pos) {
+			sync_position();
+			resolve_token(m_token);
+			m_position_pos = nullptr;
+		}
+	}
+
 	/**
 		Get the next code point from the stream and advance the parser's
 		position.
@@ -191,15 +393,28 @@ public:
 		@note If @c m_peeked==true, @c m_curchar is set to @c m_peekchar.
 		@note If there is no more data in the input stream, @c m_curchar is set
 		to @c CHAR_EOF.
+		@note This is not virtual so that it is inlined into lexers;
+		stream input goes through the decoder selected by initialize().
 
 		@returns The next code point from the input stream.
 	*/
-	virtual char32
+	char32
 	next_char() {
 		DUCT_DEBUG_ASSERTP(
-			nullptr != m_stream, this,
+			nullptr != m_stream || has_source(), this,
 			"Input stream must not be null"
 		);
+		if (has_source()) {
+			// Line and column are computed on request
+			do {
+				m_source_cur = m_source_pos;
+				m_curchar = read_source_char(m_source_pos);
+			} while (
+				CHAR_CARRIAGERETURN == m_curchar ||
+				CHAR_SENTINEL == m_curchar
+			);
+			return m_curchar;
+		}
 		if (CHAR_NEWLINE == m_curchar) {
 			++m_line;
 			m_column = 0;
@@ -207,8 +422,8 @@ public:
 		if (m_peeked) {
 			m_curchar = m_peekchar;
 			m_peeked = false;
-		} else if (m_stream->good()) {
-			m_curchar = m_stream_ctx.read_char(*m_stream, CHAR_SENTINEL);
+		} else if (m_stream_size != m_stream_pos || decode_stream_block()) {
+			m_curchar = m_stream_chars[m_stream_pos++];
 		} else {
 			m_curchar = CHAR_EOF;
 		}
@@ -224,21 +439,27 @@ public:
 		position.
 
 		@note Will peek multiple points if invalid code points are encountered.
+		@note This is not virtual; see next_char().
 
 		@returns The next code point in the input stream.
 	*/
-	virtual char32
+	char32
 	peek_char() {
 		DUCT_DEBUG_ASSERTP(
-			nullptr != m_stream, this,
+			nullptr != m_stream || has_source(), this,
 			"Input stream must not be null"
 		);
-		if (!m_peeked) {
-			if (m_stream->good()) {
-				m_peekchar = m_stream_ctx.read_char(*m_stream, CHAR_SENTINEL);
-				if (!m_stream->good()) {
-					m_peekchar = CHAR_EOF;
-				} else if (CHAR_SENTINEL == m_peekchar) {
+		if (has_source()) {
+			// Decode without consuming; invalid sequences are skipped
+			// just as they are by next_char()
+			char const* pos = m_source_pos;
+			do {
+				m_peekchar = read_source_char(pos);
+			} while (CHAR_SENTINEL == m_peekchar);
+		} else if (!m_peeked) {
+			if (m_stream_size != m_stream_pos || decode_stream_block()) {
+				m_peekchar = m_stream_chars[m_stream_pos++];
+				if (CHAR_SENTINEL == m_peekchar) {
 					return peek_char();
 				}
 			} else {
@@ -249,6 +470,71 @@ public:
 		return m_peekchar;
 	}
 
+	/**
+		Decode the code point at a position in the source buffer.
+
+		@returns
+		- The code point at @a pos; or
+		- @c CHAR_SENTINEL if the sequence at @a pos is invalid; or
+		- @c CHAR_EOF if @a pos is at the end of the source buffer or
+		  the sequence at @a pos is incomplete.
+		@param[in,out] pos Position to decode at; advanced past the
+		sequence.
+	*/
+	char32
+	read_source_char(
+		char const*& pos
+	) const noexcept {
+		if (m_source_end == pos) {
+			return CHAR_EOF;
+		} else if (0u == (0x80u & static_cast<char8_strict>(*pos))) {
+			// ASCII fast path
+			return static_cast<char32>(*pos++);
+		}
+		char32 cp;
+		char const* const next
+			= UTF8Utils::decode(pos, m_source_end, cp, CHAR_SENTINEL);
+		if (next == pos) {
+			// Incomplete sequence can only occur at the end
+			pos = m_source_end;
+			return CHAR_EOF;
+		}
+		pos = next;
+		return cp;
+	}
+
+	/**
+		Append the current code point to the token buffer.
+
+		@note When reading from a source buffer, the current code
+		point's UTF-8 sequence is referenced by the buffer instead of
+		being decoded (see CharBuf::push_back(char const*, char const*)).
+		Malformed sequences (which do not round-trip) are appended as
+		code points.
+	*/
+	void
+	buffer_current() {
+		if (!has_source()) {
+			m_token.buffer().push_back(m_curchar);
+			return;
+		}
+		std::ptrdiff_t const length = m_source_pos - m_source_cur;
+		if (1 == length && 0x80 > m_curchar) {
+			m_token.buffer().push_back(m_source_cur, m_source_pos);
+			return;
+		}
+		char units[6u];
+		char* const units_end = UTF8Utils::encode(m_curchar, units);
+		if (
+			length == (units_end - units) &&
+			std::equal(units, units_end, m_source_cur)
+		) {
+			m_token.buffer().push_back(m_source_cur, m_source_pos);
+		} else {
+			m_token.buffer().push_back(m_curchar);
+		}
+	}
+
 	/**
 		Skip data in the input stream until a code point is met.
 		@note This will check the current code point before stepping
@@ -264,6 +550,18 @@ public:
 		char32 const cp
 	) {
 		while (CHAR_EOF != m_curchar && cp != m_curchar) {
+			if (has_source()) {
+				// Skip the following run of ASCII bytes which do not
+				// match
+				char const* pos = m_source_pos;
+				for (; m_source_end != pos; ++pos) {
+					char8_strict const cu = static_cast<char8_strict>(*pos);
+					if (0x80u <= cu || cp == cu) {
+						break;
+					}
+				}
+				m_source_pos = pos;
+			}
 			next_char();
 		}
 		return cp == m_curchar;
@@ -312,9 +610,314 @@ public:
 	virtual void
 	handle_token() = 0;
 /// @}
+
+protected:
+	/**
+		Update the line and column to the current position.
+
+		@note This does nothing unless reading from a source buffer.
+	*/
+	void
+	sync_position() const noexcept {
+		if (nullptr != m_position_pos && nullptr != m_source_cur) {
+			source_position(m_source_cur, m_line, m_column);
+		}
+	}
+
+	/**
+		Set the line and column of the current position.
+
+		@param line Line position.
+		@param column Column position.
+	*/
+	void
+	set_position(
+		signed const line,
+		signed const column
+	) noexcept {
+		m_line = line;
+		m_column = column;
+		if (nullptr != m_position_pos && nullptr != m_source_cur) {
+			set_base(
+				m_source_cur, line,
+				column - ((CHAR_EOF != m_curchar) ? 1 : 0)
+			);
+		}
+	}
+
+	/**
+		Resolve the position of a token from the source buffer.
+
+		@param token Token.
+	*/
+	void
+	resolve_token(
+		Token& token
+	) const noexcept {
+		if (nullptr != token.source()) {
+			signed line, column;
+			token_position(token, line, column);
+			token.set_position(line, column);
+		}
+	}
+
+	/**
+		Get the line and column of a source position.
+
+		@param source Position of a code point or of the end of the
+		source buffer.
+		@param[out] line Line position.
+		@param[out] column Column position.
+	*/
+	void
+	source_position(
+		char const* const source,
+		signed& line,
+		signed& column
+	) const noexcept;
+
+private:
+	void
+	set_base(
+		char const* const pos,
+		signed const line,
+		signed const column
+	) noexcept {
+		m_position_pos = m_position_base = pos;
+		m_position_line = m_base_line = line;
+		m_position_column = m_base_column = column;
+	}
+
+protected:
+	/**
+		Decode the next block of code points from the stream.
+
+		@returns @c false if the stream has no more data.
+	*/
+	bool
+	decode_stream_block() {
+		if (!m_stream->good()) {
+			return false;
+		}
+		m_stream_pos = 0u;
+		m_stream_size = m_stream_decoder(
+			*m_stream, m_stream_chars.get(), stream_block_size
+		);
+		return true;
+	}
+
+	/**
+		Decode a block of code points from a stream.
+
+		@note The encoding and endian are fixed, so the whole decode
+		loop is specialized for each stream decoder. At least one code
+		point is decoded; more are decoded only while the stream's
+		buffer has data available, so reading never blocks for data
+		beyond the next code point.
+
+		@note If the stream fails, the code point that was being read
+		is followed by @c CHAR_EOF and decoding stops.
+
+		@returns The number of code points written to @a dest.
+		@tparam FromU @c EncodingUtils specialization for decoding from
+		the stream.
+		@tparam E Endian of the stream.
+		@param stream Stream to read from.
+		@param[out] dest Output code points.
+		@param count Size of @a dest; must be at least 2.
+	*/
+	template<class FromU, Endian E>
+	static unsigned
+	decode_stream_chars(
+		std::istream& stream,
+		char32* const dest,
+		unsigned const count
+	) {
+		std::streambuf* const buffer = stream.rdbuf();
+		unsigned size = 0u;
+		for (;;) {
+			dest[size++] = decode_stream_char<FromU, E>(stream);
+			if (!stream.good()) {
+				dest[size++] = CHAR_EOF;
+				break;
+			} else if (count - 1u <= size || 0 >= buffer->in_avail()) {
+				break;
+			}
+		}
+		return size;
+	}
+
+	/**
+		Decode a code point from a stream.
+
+		@note Code units are read directly from the stream's buffer; as
+		with IO::read_char(), the stream's state is set to @c eofbit
+		and @c failbit if too few units are available.
+
+		@returns The code point read from @a stream, or
+		@c CHAR_SENTINEL if it was invalid or could not be read.
+		@tparam FromU @c EncodingUtils specialization for decoding from
+		the stream.
+		@tparam E Endian of the stream.
+		@param stream Stream to read from.
+	*/
+	template<class FromU, Endian E>
+	static char32
+	decode_stream_char(
+		std::istream& stream
+	) {
+		using unit_type = typename FromU::char_type;
+		// Max UTF-8 (including invalid planes)
+		unit_type units[6u];
+		if (!read_stream_units<E>(stream, units, 1u)) {
+			return CHAR_SENTINEL;
+		} else if (4u == sizeof(unit_type)) {
+			char32 const cp = static_cast<char32>(units[0u]);
+			return DUCT_UNI_IS_CP_VALID(cp) ? cp : CHAR_SENTINEL;
+		}
+		unsigned const amt = FromU::required_first(units[0u]);
+		if (0u != amt && !read_stream_units<E>(stream, units + 1u, amt)) {
+			return CHAR_SENTINEL;
+		}
+		char32 cp;
+		unit_type const* const next = FromU::decode(
+			units, units + 1u + amt, cp, CHAR_SENTINEL
+		);
+		return (units == next) ? CHAR_SENTINEL : cp;
+	}
+
+	/**
+		Read code units from a stream's buffer.
+
+		@returns @c true if all units were read.
+		@tparam E Endian of the stream.
+		@param stream Stream to read from.
+		@param[out] dest Output units.
+		@param count Number of units to read.
+	*/
+	template<Endian E, class U>
+	static bool
+	read_stream_units(
+		std::istream& stream,
+		U* const dest,
+		std::size_t const count
+	) {
+		using traits_type = std::streambuf::traits_type;
+		std::streambuf* const buffer = stream.rdbuf();
+		if (1u == sizeof(U)) {
+			// Inline unless the buffer must be refilled
+			for (std::size_t index = 0u; count > index; ++index) {
+				auto const c = buffer->sbumpc();
+				if (traits_type::eq_int_type(traits_type::eof(), c)) {
+					stream.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+					return false;
+				}
+				dest[index] = static_cast<U>(traits_type::to_char_type(c));
+			}
+			return true;
+		}
+		std::streamsize const size
+			= static_cast<std::streamsize>(count * sizeof(U));
+		if (size != buffer->sgetn(reinterpret_cast<char*>(dest), size)) {
+			stream.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+			return false;
+		}
+		for (std::size_t index = 0u; count > index; ++index) {
+			byte_swap_ref_if(dest[index], E);
+		}
+		return true;
+	}
+
+	/**
+		Select the stream decoder for a StreamContext.
+
+		@returns The stream decoder for the encoding and endian of
+		@a context.
+		@param context StreamContext.
+	*/
+	static stream_decoder_type
+	select_stream_decoder(
+		IO::StreamContext const& context
+	) noexcept {
+		bool const little = Endian::little == context.endian();
+		switch (context.encoding()) {
+		case Encoding::UTF16:
+			return little
+				? &decode_stream_chars<UTF16Utils, Endian::little>
+				: &decode_stream_chars<UTF16Utils, Endian::big>
+			;
+		case Encoding::UTF32:
+			return little
+				? &decode_stream_chars<UTF32Utils, Endian::little>
+				: &decode_stream_chars<UTF32Utils, Endian::big>
+			;
+		default:
+			// Units are bytes; endian does not apply
+			return &decode_stream_chars<UTF8Utils, Endian::system>;
+		}
+	}
 };
 inline Parser::~Parser() = default;
 
+inline void
+Token::resolve_source() const noexcept {
+	if (nullptr != m_parser) {
+		// Cleared first: token_position() falls back to m_line and
+		// m_column when the source is not in the parser's input
+		Parser const* const parser = m_parser;
+		m_parser = nullptr;
+		parser->token_position(*this, m_line, m_column);
+	}
+}
+
+inline void
+Parser::source_position(
+	char const* const source,
+	signed& line,
+	signed& column
+) const noexcept {
+	if (source < m_position_pos) {
+		m_position_pos = m_position_base;
+		m_position_line = m_base_line;
+		m_position_column = m_base_column;
+	}
+	char const* pos = m_position_pos;
+	while (source > pos) {
+		// Run of ASCII bytes
+		char const* run = pos;
+		while (source != run && 0u == (0x80u & static_cast<char8_strict>(*run))) {
+			++run;
+		}
+		auto const newlines = std::count(pos, run, CHAR_NEWLINE);
+		if (0 < newlines) {
+			m_position_line += static_cast<signed>(newlines);
+			m_position_column = 0;
+			pos = run;
+			while (CHAR_NEWLINE != pos[-1]) {
+				--pos;
+			}
+		}
+		m_position_column += static_cast<signed>(
+			(run - pos) - std::count(pos, run, CHAR_CARRIAGERETURN)
+		);
+		pos = run;
+		if (source > pos && 0u != (0x80u & static_cast<char8_strict>(*pos))) {
+			// Invalid sequences do not count, as in next_char()
+			char32 const cp = read_source_char(pos);
+			if (CHAR_SENTINEL != cp && CHAR_EOF != cp) {
+				++m_position_column;
+			}
+		}
+	}
+	m_position_pos = pos;
+	line = m_position_line;
+	// The code point at the position counts
+	char const* next = source;
+	column = m_position_column + (
+		(CHAR_EOF != read_source_char(next)) ? 1 : 0
+	);
+}
+
 /** @} */ // end of doc-group parser
 
 } // namespace duct
@@ -0,0 +1,341 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief ductBin (binary ductScript) writer and reader.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./aux.hpp"
+#include "./string.hpp"
+#include "./debug.hpp"
+#include "./detail/var.hpp"
+#include "./detail/hash.hpp"
+#include "./VarType.hpp"
+#include "./Var.hpp"
+#include "./EndianUtils.hpp"
+#include "./IO/arithmetic.hpp"
+#include "./IO/StreamContext.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <istream>
+#include <ostream>
+
+namespace duct {
+
+/**
+	@addtogroup ductScript
+	@{
+*/
+
+// Forward declarations
+class BinaryWriter;
+class BinaryReader;
+
+/**
+	ductBin format.
+
+	ductBin is a binary encoding of a Var tree. A file consists of a
+	header, a string section and a tree section:
+
+	- header (24 bytes): the magic bytes @c "DBIN"; the version
+	  (@c 1); the endian of the following fields and of decimal
+	  values (@c 0 for little, @c 1 for big); the size of decimal
+	  values (@c 4 or @c 8); a reserved byte; and the name count,
+	  string count, string section size and tree section size as
+	  32-bit unsigned integers.
+	- string section: every distinct name and string value, each as
+	  a varint byte size followed by its UTF-8 data. Names come
+	  first, so the first @e name @e count strings are names.
+	- tree section: the root variable, each variable as a type byte,
+	  a varint name index (@c 0 for an empty name, otherwise the
+	  string index plus one) and its value: a varint string index;
+	  a zigzag varint integer; a raw IEEE decimal; or a varint child
+	  count followed by the children. Booleans are stored in the type
+	  byte.
+
+	Varints are unsigned LEB128.
+*/
+namespace binary {
+
+/** Magic bytes. */
+static constexpr char const
+MAGIC[4]{'D', 'B', 'I', 'N'};
+
+/** Format version. */
+static constexpr std::uint8_t const
+VERSION = 1u;
+
+/** Header size in bytes. */
+static constexpr std::size_t const
+HEADER_SIZE = 24u;
+
+/** Variable type byte. */
+enum class Tag : std::uint8_t {
+	null = 0u,
+	string,
+	integer,
+	decimal,
+	boolean_false,
+	boolean_true,
+	array,
+	node,
+	identifier
+};
+
+} // namespace binary
+
+/**
+	ductBin writer.
+
+	@note The StreamContext's endian is used for the header fields and
+	decimal values; its encoding is not used (strings are always
+	UTF-8).
+
+	@sa binary, BinaryReader
+*/
+class BinaryWriter final {
+private:
+	struct StringRef final {
+		char const* data;
+		std::size_t size;
+
+		bool
+		operator==(
+			StringRef const& other
+		) const noexcept {
+			return
+				size == other.size &&
+				0 == std::memcmp(data, other.data, size)
+			;
+		}
+	};
+
+	struct StringRefHash final {
+		std::size_t
+		operator()(
+			StringRef const& str
+		) const noexcept {
+			return detail::fnv1a_size(str.data, str.size);
+		}
+	};
+
+	IO::StreamContext m_stream_ctx{};
+	// Reused between writes
+	std::unordered_map<StringRef, std::uint32_t, StringRefHash> m_string_index{};
+	aux::vector<StringRef> m_strings{};
+	aux::vector<char> m_string_data{};
+	aux::vector<char> m_tree_data{};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Default constructor. */
+	BinaryWriter() = default;
+
+	/**
+		Constructor with StreamContext.
+
+		@param context StreamContext to copy.
+	*/
+	BinaryWriter(
+		IO::StreamContext context
+	) noexcept
+		: m_stream_ctx(std::move(context))
+	{}
+
+	/** Copy constructor (deleted). */
+	BinaryWriter(BinaryWriter const&) = delete;
+	/** Move constructor. */
+	BinaryWriter(BinaryWriter&&) = default;
+	/** Destructor. */
+	~BinaryWriter() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	BinaryWriter& operator=(BinaryWriter const&) = delete;
+	/** Move assignment operator. */
+	BinaryWriter& operator=(BinaryWriter&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get stream context.
+
+		@returns The current stream context.
+	*/
+	IO::StreamContext&
+	stream_context() noexcept {
+		return m_stream_ctx;
+	}
+	/** @copydoc stream_context() */
+	IO::StreamContext const&
+	stream_context() const noexcept {
+		return m_stream_ctx;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Write a variable to a stream.
+
+		@note The whole tree is encoded before it is written.
+
+		@returns
+		- @c true if the variable was written to the stream, or
+		- @c false if a stream operation failed or the encoded
+		  variable does not fit the format's 32-bit sizes.
+		@param dest Destination stream.
+		@param source Source variable. Can be any type.
+	*/
+	bool
+	write(
+		std::ostream& dest,
+		Var const& source
+	);
+/// @}
+
+private:
+	std::uint32_t
+	string_index(
+		u8string const& str
+	);
+
+	void
+	add_names(
+		Var const& var
+	);
+
+	void
+	encode(
+		Var const& var
+	);
+};
+
+/**
+	ductBin reader.
+
+	@note The StreamContext's endian is set from the header of each
+	read; its encoding is not used (strings are always UTF-8).
+	@note The sections are read in blocks that grow with the data read
+	so far, so sizes in a corrupt header fail on the stream instead of
+	allocating up front. Decoding works on the read data and allocates
+	only the output variables.
+
+	@sa binary, BinaryWriter
+*/
+class BinaryReader final {
+private:
+	struct StringRef final {
+		char const* data;
+		std::size_t size;
+	};
+
+	IO::StreamContext m_stream_ctx{};
+	unsigned m_decimal_size{0u};
+	unsigned m_max_depth{256u};
+	// Reused between reads
+	aux::vector<char> m_data{};
+	aux::vector<StringRef> m_strings{};
+	aux::vector<detail::var_config::name_type> m_names{};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Default constructor. */
+	BinaryReader() = default;
+	/** Copy constructor (deleted). */
+	BinaryReader(BinaryReader const&) = delete;
+	/** Move constructor. */
+	BinaryReader(BinaryReader&&) = default;
+	/** Destructor. */
+	~BinaryReader() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	BinaryReader& operator=(BinaryReader const&) = delete;
+	/** Move assignment operator. */
+	BinaryReader& operator=(BinaryReader&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get stream context.
+
+		@returns The current stream context.
+	*/
+	IO::StreamContext const&
+	stream_context() const noexcept {
+		return m_stream_ctx;
+	}
+
+	/**
+		Set maximum depth.
+
+		@note Collections are decoded recursively, so data nested
+		deeper than this is rejected rather than risk overflowing the
+		stack. The root is at depth 0.
+
+		@param max_depth Maximum depth of a variable; @c 256 by
+		default.
+	*/
+	void
+	set_max_depth(
+		unsigned const max_depth
+	) noexcept {
+		m_max_depth = max_depth;
+	}
+
+	/**
+		Get maximum depth.
+
+		@sa set_max_depth()
+	*/
+	unsigned
+	max_depth() const noexcept {
+		return m_max_depth;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Read a variable from a stream.
+
+		@note @a dest is only assigned if the read succeeds.
+
+		@returns
+		- @c true if the variable was read, or
+		- @c false if a stream operation failed, the data is not
+		  valid ductBin, or it is nested deeper than max_depth().
+		@param src Source stream.
+		@param[out] dest Output variable.
+	*/
+	bool
+	read(
+		std::istream& src,
+		Var& dest
+	);
+/// @}
+
+private:
+	bool
+	decode(
+		char const*& pos,
+		char const* const end,
+		Var& parent,
+		unsigned depth
+	);
+};
+
+#include "./impl/ScriptBinary.inl"
+
+/** @} */ // end of doc-group ductScript
+
+} // namespace duct
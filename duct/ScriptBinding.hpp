@@ -0,0 +1,896 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief ductScript binding to user types.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./debug.hpp"
+#include "./aux.hpp"
+#include "./string.hpp"
+#include "./CharBuf.hpp"
+#include "./VarType.hpp"
+#include "./Parser.hpp"
+#include "./ScriptHandler.hpp"
+
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace duct {
+
+// Forward declarations
+template<class C, class M>
+struct ScriptField;
+template<class T>
+struct ScriptBinding;
+class ScriptBindingException;
+class ScriptBinder;
+
+/**
+	@addtogroup ductScript
+	@{
+*/
+
+/**
+	ScriptBinder errors.
+*/
+enum class ScriptBindingError : unsigned {
+	/** A name does not match any field. */
+	unknown_field,
+	/** A value or collection does not match the type of its field. */
+	type_mismatch,
+	/** A value could not be converted to the type of its field. */
+	invalid_value
+};
+
+/**
+	ScriptBinder exception.
+*/
+class ScriptBindingException final
+	: public std::exception
+{
+private:
+	ScriptBindingError m_error;
+	char m_message[512];
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Default constructor (deleted). */
+	ScriptBindingException() = delete;
+
+	/**
+		Construct with details.
+
+		@param error Error.
+		@param parser Parser to get the position from; may be
+		@c nullptr.
+		@param fmt Message format string.
+		@param ... Message parameters.
+	*/
+	ScriptBindingException(
+		ScriptBindingError const error,
+		Parser const* const parser,
+		char const fmt[],
+		...
+	);
+
+	/** Copy constructor (deleted). */
+	ScriptBindingException(ScriptBindingException const&) = delete;
+	/** Move constructor. */
+	ScriptBindingException(ScriptBindingException&&) = default;
+	/** Destructor. */
+	~ScriptBindingException() noexcept override = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	ScriptBindingException& operator=(ScriptBindingException const&) = delete;
+	/** Move assignment operator. */
+	ScriptBindingException& operator=(ScriptBindingException&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get error.
+	*/
+	ScriptBindingError
+	error() const noexcept {
+		return m_error;
+	}
+
+	/**
+		Get error message.
+
+		@returns The error message.
+	*/
+	char const*
+	what() const noexcept override {
+		return m_message;
+	}
+/// @}
+};
+
+/**
+	Field descriptor.
+
+	@note The type of the field is the type of value or collection
+	it is bound from:
+
+	- a value type for arithmetic and string members (an integer is
+	  also accepted for @c VarType::decimal);
+	- @c VarType::node for bound struct members;
+	- @c VarType::array or @c VarType::identifier for @c std::vector
+	  members, whose elements are bound from the collection's values
+	  (or arrays, for nested vectors); or
+	- @c VarType::node or a value type for @c std::vector members,
+	  which are appended to by every node or value with the field's
+	  name.
+
+	@sa script_field()
+
+	@tparam C Class type.
+	@tparam M Member type.
+*/
+template<class C, class M>
+struct ScriptField final {
+	/** Name. */
+	char const* name;
+	/** Member. */
+	M C::* member;
+	/** Type. */
+	VarType type;
+};
+
+/**
+	Make a field descriptor.
+
+	@returns Field descriptor.
+	@param name Name.
+	@param member Member.
+	@param type Type.
+*/
+template<class C, class M>
+constexpr ScriptField<C, M>
+script_field(
+	char const* const name,
+	M C::* const member,
+	VarType const type
+) noexcept {
+	return ScriptField<C, M>{name, member, type};
+}
+
+/**
+	Binding of a struct.
+
+	@note This must be specialized for every struct bound by
+	ScriptBinder. The specialization gives the struct's fields to
+	a function object in a static function template:
+
+	@code
+	template<>
+	struct ScriptBinding<Server> {
+		template<class F>
+		static void
+		fields(F&& f) {
+			f(
+				script_field("host", &Server::host, VarType::string),
+				script_field("port", &Server::port, VarType::integer)
+			);
+		}
+	};
+	@endcode
+
+	@tparam T Struct type.
+*/
+template<class T>
+struct ScriptBinding;
+
+/** @cond INTERNAL */
+namespace detail {
+
+template<class T>
+struct is_script_vector
+	: public std::false_type
+{};
+
+template<class T, class A>
+struct is_script_vector<std::vector<T, A>>
+	: public std::true_type
+{};
+
+template<class T>
+struct is_script_string
+	: public std::false_type
+{};
+
+template<class C, class Tr, class A>
+struct is_script_string<std::basic_string<C, Tr, A>>
+	: public std::true_type
+{};
+
+// Type a member is bound from if its field does not say
+template<class T>
+struct script_value_type
+	: public std::integral_constant<VarType,
+		std::is_same<T, bool>::value ? VarType::boolean
+		: std::is_integral<T>::value ? VarType::integer
+		: std::is_floating_point<T>::value ? VarType::decimal
+		: is_script_string<T>::value ? VarType::string
+		: is_script_vector<T>::value ? VarType::array
+		: VarType::node
+	>
+{};
+
+} // namespace detail
+/** @endcond */ // INTERNAL
+
+/**
+	ductScript event handler that binds to a struct.
+
+	@note Values are converted directly into the fields of the struct
+	(see ScriptField and ScriptBinding) without building a Var tree.
+	Fields which do not appear in the document are not modified.
+
+	@note A ScriptBindingException is thrown if the document does not
+	match the struct. The state of the struct is undefined if an
+	exception is thrown.
+*/
+class ScriptBinder final
+	: public ScriptHandler
+{
+private:
+	struct Frame;
+
+	struct Ops final {
+		void (*value)(
+			ScriptBinder&, Frame const&,
+			CharBuf const&, VarType const, CharBuf const&
+		);
+		Frame (*begin)(
+			ScriptBinder&, Frame const&,
+			VarType const, CharBuf const&
+		);
+	};
+
+	// An ignored collection has no ops
+	struct Frame final {
+		void* object;
+		Ops const* ops;
+		char const* name;
+	};
+
+	template<class T, class Action>
+	struct FieldFinder;
+	struct ValueAction;
+	struct BeginAction;
+
+	template<VarType K>
+	using kind = std::integral_constant<VarType, K>;
+
+	duct::aux::vector<Frame> m_stack{};
+	Parser const* m_parser{nullptr};
+	bool m_ignore_unknown{false};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/**
+		Construct without object.
+
+		@sa reset(T&, Parser const*)
+	*/
+	ScriptBinder() = default;
+
+	/** Copy constructor. */
+	ScriptBinder(ScriptBinder const&) = default;
+	/** Move constructor. */
+	ScriptBinder(ScriptBinder&&) = default;
+	/** Destructor. */
+	~ScriptBinder() override = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	ScriptBinder& operator=(ScriptBinder const&) = default;
+	/** Move assignment operator. */
+	ScriptBinder& operator=(ScriptBinder&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Set whether to ignore unknown names.
+
+		@note If this is enabled, values and collections which do not
+		match a field are skipped instead of being an error.
+		It is disabled by default.
+
+		@param ignore_unknown Whether to ignore unknown names.
+	*/
+	void
+	set_ignore_unknown(
+		bool const ignore_unknown
+	) noexcept {
+		m_ignore_unknown = ignore_unknown;
+	}
+
+	/**
+		Get whether to ignore unknown names.
+	*/
+	bool
+	ignore_unknown() const noexcept {
+		return m_ignore_unknown;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Reset with object.
+
+		@param[out] object Object; @a T must have a ScriptBinding.
+		@param parser Parser to report positions from; may be
+		@c nullptr.
+	*/
+	template<class T>
+	void
+	reset(
+		T& object,
+		Parser const* const parser = nullptr
+	) {
+		static_assert(
+			VarType::node == detail::script_value_type<T>::value,
+			"T must be a struct"
+		);
+		m_stack.clear();
+		m_stack.push_back(Frame{&object, &struct_ops<T>(), ""});
+		m_parser = parser;
+	}
+/// @}
+
+/** @name Events */ /// @{
+	void
+	on_node_begin(
+		CharBuf const& name
+	) override {
+		begin(VarType::node, name);
+	}
+
+	void
+	on_node_end() override {
+		m_stack.pop_back();
+	}
+
+	void
+	on_identifier_begin(
+		CharBuf const& name
+	) override {
+		begin(VarType::identifier, name);
+	}
+
+	void
+	on_identifier_end() override {
+		m_stack.pop_back();
+	}
+
+	void
+	on_array_begin(
+		CharBuf const& name
+	) override {
+		begin(VarType::array, name);
+	}
+
+	void
+	on_array_end() override {
+		m_stack.pop_back();
+	}
+
+	void
+	on_value(
+		CharBuf const& name,
+		VarType const type,
+		CharBuf const& text
+	) override {
+		DUCT_DEBUG_ASSERTP(
+			!m_stack.empty(), this,
+			"reset() must be called first"
+		);
+		Frame const& frame = m_stack.back();
+		if (nullptr != frame.ops) {
+			frame.ops->value(*this, frame, name, type, text);
+		}
+	}
+/// @}
+
+private:
+	void
+	begin(
+		VarType const type,
+		CharBuf const& name
+	) {
+		DUCT_DEBUG_ASSERTP(
+			!m_stack.empty(), this,
+			"reset() must be called first"
+		);
+		Frame const frame = m_stack.back();
+		if (nullptr == frame.ops) {
+			m_stack.push_back(frame);
+		} else {
+			m_stack.push_back(frame.ops->begin(*this, frame, type, name));
+		}
+	}
+
+	static bool
+	accepts(
+		VarType const expected,
+		VarType const type
+	) noexcept {
+		return
+			expected == type ||
+			(VarType::decimal == expected && VarType::integer == type)
+		;
+	}
+
+	[[noreturn]] void
+	mismatch(
+		char const* const name,
+		VarType const expected,
+		VarType const type
+	) const {
+		throw ScriptBindingException{
+			ScriptBindingError::type_mismatch, m_parser,
+			"field '%s' expects %s, got %s",
+			name, var_type_name(expected), var_type_name(type)
+		};
+	}
+
+	Frame
+	unknown(
+		CharBuf const& name
+	) const {
+		if (m_ignore_unknown) {
+			return Frame{nullptr, nullptr, nullptr};
+		}
+		throw ScriptBindingException{
+			ScriptBindingError::unknown_field, m_parser,
+			"unknown field '%s'",
+			name.to_string<u8string>().c_str()
+		};
+	}
+
+	// Values
+
+	template<class M>
+	void
+	assign(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type,
+		CharBuf const& text
+	) {
+		assign(
+			name, expected, member, type, text,
+			kind<detail::script_value_type<M>::value>{}
+		);
+	}
+
+	template<class M>
+	void
+	assign(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type,
+		CharBuf const& text,
+		kind<VarType::string>
+	) {
+		if (!accepts(expected, type)) {
+			mismatch(name, expected, type);
+		}
+		text.to_string(member);
+	}
+
+	void
+	assign(
+		char const* const name,
+		VarType const expected,
+		bool& member,
+		VarType const type,
+		CharBuf const& text,
+		kind<VarType::boolean>
+	) {
+		if (!accepts(expected, type)) {
+			mismatch(name, expected, type);
+		} else if (VarType::boolean == type) {
+			// The literal is either "true" or "false"
+			member = 4u == text.size();
+		} else {
+			convert(name, member, type, text);
+		}
+	}
+
+	template<class M>
+	void
+	assign(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type,
+		CharBuf const& text,
+		kind<VarType::integer>
+	) {
+		if (!accepts(expected, type)) {
+			mismatch(name, expected, type);
+		}
+		convert(name, member, type, text);
+	}
+
+	template<class M>
+	void
+	assign(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type,
+		CharBuf const& text,
+		kind<VarType::decimal>
+	) {
+		if (!accepts(expected, type)) {
+			mismatch(name, expected, type);
+		}
+		convert(name, member, type, text);
+	}
+
+	// Every value with the field's name is appended
+	template<class M>
+	void
+	assign(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type,
+		CharBuf const& text,
+		kind<VarType::array>
+	) {
+		if (var_type_is_of(expected, VarMask::collection)) {
+			mismatch(name, expected, type);
+		}
+		typename M::value_type element{};
+		assign(name, expected, element, type, text);
+		member.push_back(std::move(element));
+	}
+
+	template<class M>
+	void
+	assign(
+		char const* const name,
+		VarType const expected,
+		M& /*member*/,
+		VarType const type,
+		CharBuf const& /*text*/,
+		kind<VarType::node>
+	) {
+		mismatch(name, expected, type);
+	}
+
+	template<class M>
+	void
+	convert(
+		char const* const name,
+		M& member,
+		VarType const type,
+		CharBuf const& text
+	) const {
+		if (!text.to_arithmetic(member)) {
+			throw ScriptBindingException{
+				ScriptBindingError::invalid_value, m_parser,
+				"field '%s' has invalid %s value '%s'",
+				name, var_type_name(type),
+				text.to_string<u8string>().c_str()
+			};
+		}
+	}
+
+	// Collections
+
+	template<class M>
+	Frame
+	begin_member(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type
+	) {
+		return begin_member(
+			name, expected, member, type,
+			kind<detail::script_value_type<M>::value>{}
+		);
+	}
+
+	template<class M, VarType K>
+	Frame
+	begin_member(
+		char const* const name,
+		VarType const expected,
+		M& /*member*/,
+		VarType const type,
+		kind<K>
+	) {
+		mismatch(name, expected, type);
+	}
+
+	template<class M>
+	Frame
+	begin_member(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type,
+		kind<VarType::node>
+	) {
+		if (VarType::node != expected || VarType::node != type) {
+			mismatch(name, expected, type);
+		}
+		return Frame{&member, &struct_ops<M>(), name};
+	}
+
+	template<class M>
+	Frame
+	begin_member(
+		char const* const name,
+		VarType const expected,
+		M& member,
+		VarType const type,
+		kind<VarType::array>
+	) {
+		if (expected != type) {
+			mismatch(name, expected, type);
+		} else if (VarType::node == type) {
+			return append_node(
+				name, member,
+				kind<detail::script_value_type<
+					typename M::value_type
+				>::value>{}
+			);
+		}
+		member.clear();
+		return Frame{&member, &vector_ops<M>(), name};
+	}
+
+	template<class M, VarType K>
+	Frame
+	append_node(
+		char const* const name,
+		M& /*member*/,
+		kind<K>
+	) {
+		mismatch(name, K, VarType::node);
+	}
+
+	// Every node with the field's name is appended
+	template<class M>
+	Frame
+	append_node(
+		char const* const name,
+		M& member,
+		kind<VarType::node>
+	) {
+		member.emplace_back();
+		return Frame{
+			&member.back(), &struct_ops<typename M::value_type>(), name
+		};
+	}
+
+	// Struct frames
+
+	template<class T>
+	static Ops const&
+	struct_ops() noexcept {
+		static Ops const s_ops{&struct_value<T>, &struct_begin<T>};
+		return s_ops;
+	}
+
+	template<class T>
+	static void
+	struct_value(
+		ScriptBinder& binder,
+		Frame const& frame,
+		CharBuf const& name,
+		VarType const type,
+		CharBuf const& text
+	);
+
+	template<class T>
+	static Frame
+	struct_begin(
+		ScriptBinder& binder,
+		Frame const& frame,
+		VarType const type,
+		CharBuf const& name
+	);
+
+	// Vector frames
+
+	template<class M>
+	static Ops const&
+	vector_ops() noexcept {
+		static Ops const s_ops{&vector_value<M>, &vector_begin<M>};
+		return s_ops;
+	}
+
+	template<class M>
+	static void
+	vector_value(
+		ScriptBinder& binder,
+		Frame const& frame,
+		CharBuf const& /*name*/,
+		VarType const type,
+		CharBuf const& text
+	) {
+		using element_type = typename M::value_type;
+		VarType const expected
+			= detail::script_value_type<element_type>::value;
+		element_type element{};
+		binder.assign(frame.name, expected, element, type, text);
+		static_cast<M*>(frame.object)->push_back(std::move(element));
+	}
+
+	template<class M>
+	static Frame
+	vector_begin(
+		ScriptBinder& binder,
+		Frame const& frame,
+		VarType const type,
+		CharBuf const& /*name*/
+	) {
+		using element_type = typename M::value_type;
+		VarType const expected
+			= detail::script_value_type<element_type>::value;
+		// Only nested vectors can be bound from collections in arrays
+		if (VarType::array != expected) {
+			binder.mismatch(frame.name, expected, type);
+		}
+		auto& member = *static_cast<M*>(frame.object);
+		member.emplace_back();
+		return binder.begin_member(frame.name, type, member.back(), type);
+	}
+};
+
+/** @} */ // end of doc-group ductScript
+
+inline
+ScriptBindingException::ScriptBindingException(
+	ScriptBindingError const error,
+	Parser const* const parser,
+	char const fmt[],
+	...
+)
+	: std::exception()
+	, m_error(error)
+{
+	char formatted_message[384];
+	va_list args;
+	va_start(args, fmt);
+	std::vsnprintf(formatted_message, 384, fmt, args);
+	va_end(args);
+	if (parser) {
+		std::snprintf(m_message, 512,
+			"at [%d:%d]: %s",
+			parser->line(), parser->column(),
+			formatted_message
+		);
+	} else {
+		std::snprintf(m_message, 512, "%s", formatted_message);
+	}
+}
+
+// Finds a field by name and applies an action to it
+template<class T, class Action>
+struct ScriptBinder::FieldFinder final {
+	T& object;
+	CharBuf const& name;
+	Action& action;
+	bool found;
+
+	template<class... F>
+	void
+	operator()(
+		F const&... fields
+	) {
+		find(fields...);
+	}
+
+	void
+	find() noexcept {}
+
+	template<class C, class M, class... R>
+	void
+	find(
+		ScriptField<C, M> const& field,
+		R const&... rest
+	) {
+		if (name.equals(field.name, field.name + std::strlen(field.name))) {
+			found = true;
+			action(field, object.*field.member);
+		} else {
+			find(rest...);
+		}
+	}
+};
+
+struct ScriptBinder::ValueAction final {
+	ScriptBinder& binder;
+	VarType type;
+	CharBuf const& text;
+
+	template<class C, class M>
+	void
+	operator()(
+		ScriptField<C, M> const& field,
+		M& member
+	) {
+		binder.assign(field.name, field.type, member, type, text);
+	}
+};
+
+struct ScriptBinder::BeginAction final {
+	ScriptBinder& binder;
+	VarType type;
+	Frame frame;
+
+	template<class C, class M>
+	void
+	operator()(
+		ScriptField<C, M> const& field,
+		M& member
+	) {
+		frame = binder.begin_member(field.name, field.type, member, type);
+	}
+};
+
+template<class T>
+inline void
+ScriptBinder::struct_value(
+	ScriptBinder& binder,
+	Frame const& frame,
+	CharBuf const& name,
+	VarType const type,
+	CharBuf const& text
+) {
+	ValueAction action{binder, type, text};
+	FieldFinder<T, ValueAction> finder{
+		*static_cast<T*>(frame.object), name, action, false
+	};
+	ScriptBinding<T>::fields(finder);
+	if (!finder.found) {
+		binder.unknown(name);
+	}
+}
+
+template<class T>
+inline ScriptBinder::Frame
+ScriptBinder::struct_begin(
+	ScriptBinder& binder,
+	Frame const& frame,
+	VarType const type,
+	CharBuf const& name
+) {
+	BeginAction action{binder, type, Frame{nullptr, nullptr, nullptr}};
+	FieldFinder<T, BeginAction> finder{
+		*static_cast<T*>(frame.object), name, action, false
+	};
+	ScriptBinding<T>::fields(finder);
+	if (!finder.found) {
+		return binder.unknown(name);
+	}
+	return action.frame;
+}
+
+} // namespace duct
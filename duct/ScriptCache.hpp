@@ -0,0 +1,295 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief ScriptCache class.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./string.hpp"
+#include "./detail/hash.hpp"
+#include "./Var.hpp"
+#include "./ScriptParser.hpp"
+#include "./ScriptBinary.hpp"
+#include "./IO/arithmetic.hpp"
+#include "./IO/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <utility>
+
+#if defined(DUCT_PLATFORM_SYSTEM_WINDOWS)
+	#include <process.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace duct {
+
+// Forward declarations
+class ScriptCache;
+
+/**
+	@addtogroup ductScript
+	@{
+*/
+
+/**
+	ductScript parse cache.
+
+	@note Each processed file has a ductBin snapshot in the cache
+	directory, named by a hash of the file's path. The snapshot
+	records a hash and the size of the file's contents. If they match
+	the file, the tree is read from the snapshot instead of parsing
+	the file. Otherwise, the file is parsed and its snapshot is
+	rewritten.
+	@note The cache directory must exist. Failing to read or write a
+	snapshot is not an error; the file is parsed instead.
+	@note Snapshots are written to a temporary file named by the
+	process ID and a random number, then renamed over the snapshot,
+	so processes sharing a cache directory do not write over each
+	other's partial snapshots.
+	@note Snapshots are written in the system endian with the
+	current Var configuration. Snapshots from another configuration
+	are rewritten if their values do not fit.
+
+	@sa BinaryWriter, BinaryReader
+*/
+class ScriptCache final {
+private:
+	u8string m_directory;
+	ScriptParser m_parser{};
+	BinaryWriter m_writer{};
+	BinaryReader m_reader{};
+	std::size_t m_hits{0u};
+	std::size_t m_misses{0u};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/**
+		Construct with cache directory.
+
+		@param directory Path of cache directory.
+	*/
+	explicit
+	ScriptCache(
+		u8string directory
+	)
+		: m_directory(std::move(directory))
+	{}
+
+	/** Copy constructor (deleted). */
+	ScriptCache(ScriptCache const&) = delete;
+	/** Move constructor. */
+	ScriptCache(ScriptCache&&) = default;
+	/** Destructor. */
+	~ScriptCache() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	ScriptCache& operator=(ScriptCache const&) = delete;
+	/** Move assignment operator. */
+	ScriptCache& operator=(ScriptCache&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get cache directory.
+	*/
+	u8string const&
+	directory() const noexcept {
+		return m_directory;
+	}
+
+	/**
+		Get parser.
+
+		@note This is the parser used when a snapshot misses.
+	*/
+	ScriptParser&
+	parser() noexcept {
+		return m_parser;
+	}
+
+	/**
+		Get number of files read from snapshots.
+	*/
+	std::size_t
+	hits() const noexcept {
+		return m_hits;
+	}
+
+	/**
+		Get number of files parsed.
+	*/
+	std::size_t
+	misses() const noexcept {
+		return m_misses;
+	}
+
+	/**
+		Reset hit and miss counts.
+	*/
+	void
+	reset_counts() noexcept {
+		m_hits = 0u;
+		m_misses = 0u;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Process a UTF-8 file through the cache.
+
+		@throws ScriptParserException
+		If the file is parsed and an error occurs.
+
+		@returns @c true on success; @c false if the file could not
+		be mapped.
+		@param[out] node Output node; replaced by the file's root node.
+		@param path Path of file to process.
+		@sa ScriptParser::process_file(Var&, char const*)
+	*/
+	bool
+	process_file(
+		Var& node,
+		u8string const& path
+	);
+
+	/**
+		Get the snapshot path for a file.
+
+		@param path Path of file.
+	*/
+	u8string
+	snapshot_path(
+		u8string const& path
+	) const;
+/// @}
+
+private:
+	static void
+	append_hex(
+		u8string& str,
+		std::uint64_t const value
+	) {
+		static char const s_digits[]{"0123456789abcdef"};
+		for (unsigned shift = 64u; 0u < shift;) {
+			shift -= 4u;
+			str.push_back(s_digits[(value >> shift) & 0xFu]);
+		}
+	}
+
+	static u8string
+	temporary_path(
+		u8string const& snapshot
+	);
+};
+
+/** @} */ // end of doc-group ductScript
+
+inline u8string
+ScriptCache::snapshot_path(
+	u8string const& path
+) const {
+	u8string snapshot{m_directory};
+	if (!snapshot.empty() && '/' != snapshot.back()) {
+		snapshot.push_back('/');
+	}
+	append_hex(snapshot, detail::fnv1a<std::uint64_t>(path.data(), path.size()));
+	snapshot.append(".dbin");
+	return snapshot;
+}
+
+inline u8string
+ScriptCache::temporary_path(
+	u8string const& snapshot
+) {
+#if defined(DUCT_PLATFORM_SYSTEM_WINDOWS)
+	auto const pid = static_cast<std::uint64_t>(::_getpid());
+#else
+	auto const pid = static_cast<std::uint64_t>(::getpid());
+#endif
+	std::random_device device{};
+	std::uint64_t const salt
+		= (static_cast<std::uint64_t>(device()) << 32u)
+		^ static_cast<std::uint64_t>(device())
+	;
+	u8string temporary{snapshot};
+	temporary.push_back('.');
+	append_hex(temporary, pid);
+	temporary.push_back('.');
+	append_hex(temporary, salt);
+	temporary.append(".tmp");
+	return temporary;
+}
+
+inline bool
+ScriptCache::process_file(
+	Var& node,
+	u8string const& path
+) {
+	IO::MappedFile const file{path.c_str()};
+	if (!file.is_open()) {
+		return false;
+	}
+	std::uint64_t const content_hash
+		= detail::fnv1a<std::uint64_t>(file.data(), file.size())
+	;
+	std::uint64_t const content_size = file.size();
+	u8string const snapshot = snapshot_path(path);
+
+	std::ifstream input{snapshot.c_str(), std::ios_base::binary};
+	if (input.is_open()) {
+		std::uint64_t key[2u];
+		IO::read_arithmetic_array(input, key, 2u);
+		if (
+			!input.fail() &&
+			content_hash == key[0u] &&
+			content_size == key[1u] &&
+			m_reader.read(input, node)
+		) {
+			++m_hits;
+			return true;
+		}
+		input.close();
+	}
+
+	++m_misses;
+	Var root{VarType::node};
+	m_parser.process(root, file.data(), file.data() + file.size());
+
+	// Write aside and replace, so a failed write never leaves a
+	// partial snapshot
+	u8string const temporary = temporary_path(snapshot);
+	std::ofstream output{
+		temporary.c_str(),
+		std::ios_base::binary | std::ios_base::trunc
+	};
+	if (output.is_open()) {
+		std::uint64_t const key[2u]{content_hash, content_size};
+		IO::write_arithmetic_array(output, key, 2u);
+		bool const written = m_writer.write(output, root);
+		output.close();
+		if (
+			!written || output.fail() || (
+				0 != std::rename(temporary.c_str(), snapshot.c_str()) && (
+					std::remove(snapshot.c_str()),
+					0 != std::rename(temporary.c_str(), snapshot.c_str())
+				)
+			)
+		) {
+			std::remove(temporary.c_str());
+		}
+	}
+	node = std::move(root);
+	return true;
+}
+
+} // namespace duct
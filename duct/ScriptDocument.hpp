@@ -0,0 +1,407 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief ScriptDocument class.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./aux.hpp"
+#include "./string.hpp"
+#include "./IO/MappedFile.hpp"
+#include "./Var.hpp"
+#include "./ScriptParser.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace duct {
+
+// Forward declarations
+class ScriptDocument;
+
+/**
+	@addtogroup ductScript
+	@{
+*/
+
+/**
+	Lazily-processed ductScript document.
+
+	@note When a document is opened, only the root's direct children
+	are processed; the bodies of nodes are deferred (see
+	ScriptParser::process_deferred()) and the nodes are empty until
+	they are loaded. Loading a node processes its body, deferring the
+	bodies of its own child nodes in turn. A loaded node stays loaded.
+
+	@note Errors within a deferred body are reported (by throwing
+	ScriptParserException) when it is loaded, and the node is left
+	unloaded.
+
+	@note Unloaded nodes are identified by their position in the
+	tree, not by address, so they are kept when the tree's
+	collections are moved (as by copy-on-write; see
+	#DUCT_CONFIG_VAR_COPY_ON_WRITE).
+
+	@warning Adding or removing children of a collection may change
+	the positions of the children after them, so any unloaded nodes
+	within it must be loaded first (see load_all()).
+*/
+class ScriptDocument final {
+private:
+	// Unloaded children of a node
+	struct DeferredParent final {
+		// Child positions from the root to the node
+		duct::aux::vector<std::size_t> path;
+		// Bodies in position order
+		ScriptParser::deferred_vector_type bodies;
+	};
+
+	IO::MappedFile m_file{};
+	duct::aux::vector<char> m_data{};
+	Var m_root{VarType::node};
+	duct::aux::vector<DeferredParent> m_deferred{};
+	std::size_t m_unloaded{0u};
+	ScriptParser::deferred_vector_type m_scratch{};
+	ScriptParser m_parser{};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Construct empty. */
+	ScriptDocument() = default;
+	/** Copy constructor (deleted). */
+	ScriptDocument(ScriptDocument const&) = delete;
+	/** Move constructor. */
+	ScriptDocument(ScriptDocument&&) = default;
+	/** Destructor. */
+	~ScriptDocument() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	ScriptDocument& operator=(ScriptDocument const&) = delete;
+	/** Move assignment operator. */
+	ScriptDocument& operator=(ScriptDocument&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get parser.
+
+		@note This can be used to set the lexer and arena.
+	*/
+	ScriptParser&
+	parser() noexcept {
+		return m_parser;
+	}
+
+	/**
+		Get root.
+
+		@note Unloaded nodes in the tree are empty.
+	*/
+	Var&
+	root() noexcept {
+		return m_root;
+	}
+
+	/**
+		Check if a node is loaded.
+
+		@returns @c false iff @a var is an unloaded node of this
+		document.
+		@param var Variable.
+	*/
+	bool
+	is_loaded(
+		Var const& var
+	) const {
+		std::size_t parent_index;
+		std::size_t body_index;
+		return !find_deferred(var, parent_index, body_index);
+	}
+
+	/**
+		Get number of unloaded nodes.
+	*/
+	std::size_t
+	unloaded_count() const noexcept {
+		return m_unloaded;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Open a file.
+
+		@note The file is mapped for the lifetime of the document.
+
+		@throws ScriptParserException If an error occurs while
+		processing the root.
+
+		@returns @c true on success; @c false if the file could not
+		be mapped.
+		@param path Path of file.
+	*/
+	bool
+	open(
+		char const* const path
+	) {
+		clear();
+		if (!m_file.open(path)) {
+			return false;
+		}
+		return process(m_file.begin(), m_file.end());
+	}
+
+	/** @copydoc open(char const*) */
+	bool
+	open(
+		u8string const& path
+	) {
+		return open(path.c_str());
+	}
+
+	/**
+		Assign from a UTF-8 source buffer.
+
+		@note The buffer is copied.
+
+		@throws ScriptParserException If an error occurs while
+		processing the root.
+
+		@returns @c true on success.
+		@param begin Beginning of source buffer.
+		@param end End of source buffer.
+	*/
+	bool
+	assign(
+		char const* const begin,
+		char const* const end
+	) {
+		clear();
+		if (begin > end) {
+			return false;
+		}
+		m_data.assign(begin, end);
+		return process(m_data.data(), m_data.data() + m_data.size());
+	}
+
+	/**
+		Clear the document.
+	*/
+	void
+	clear() {
+		m_deferred.clear();
+		m_unloaded = 0u;
+		m_root = Var{VarType::node};
+		m_data.clear();
+		m_file.close();
+	}
+
+	/**
+		Load a node.
+
+		@throws ScriptParserException If an error occurs while
+		processing the node's body.
+
+		@returns @a var.
+		@param var Variable; nothing is done if it is not an unloaded
+		node.
+	*/
+	Var&
+	load(
+		Var& var
+	);
+
+	/**
+		Load all nodes.
+
+		@throws ScriptParserException If an error occurs while
+		processing a node's body.
+
+		@returns The root.
+	*/
+	Var&
+	load_all() {
+		load_tree(m_root);
+		return m_root;
+	}
+
+	/**
+		Find and load a child by name.
+
+		@throws ScriptParserException If an error occurs while
+		processing the child's body.
+
+		@returns The first child of @a parent named @a name, or
+		@c nullptr if there is none.
+		@param parent Parent collection; must be loaded.
+		@param name Name to find.
+	*/
+	Var*
+	find(
+		Var& parent,
+		u8string const& name
+	) {
+		Var* const child = parent.find(name);
+		return (nullptr != child) ? &load(*child) : nullptr;
+	}
+
+	/**
+		Find and load a child of the root by name.
+
+		@sa find(Var&, u8string const&)
+	*/
+	Var*
+	find(
+		u8string const& name
+	) {
+		return find(m_root, name);
+	}
+/// @}
+
+private:
+	bool
+	process(
+		char const* const begin,
+		char const* const end
+	);
+
+	bool
+	find_deferred(
+		Var const& var,
+		std::size_t& parent_index,
+		std::size_t& body_index
+	) const;
+
+	void
+	add_deferred(
+		duct::aux::vector<std::size_t> path
+	);
+
+	void
+	load_tree(
+		Var& var
+	);
+};
+
+/** @} */ // end of doc-group ductScript
+
+inline Var&
+ScriptDocument::load(
+	Var& var
+) {
+	std::size_t parent_index;
+	std::size_t body_index;
+	if (!find_deferred(var, parent_index, body_index)) {
+		return var;
+	}
+	auto& parent = m_deferred[parent_index];
+	ScriptParser::DeferredNode const body = parent.bodies[body_index];
+	duct::aux::vector<std::size_t> path = parent.path;
+	path.push_back(body.index);
+	m_scratch.clear();
+	try {
+		m_parser.process_deferred(var, body, m_scratch);
+	} catch (...) {
+		var.children().clear();
+		throw;
+	}
+	parent.bodies.erase(parent.bodies.begin() + body_index);
+	if (parent.bodies.empty()) {
+		m_deferred.erase(m_deferred.begin() + parent_index);
+	}
+	--m_unloaded;
+	add_deferred(std::move(path));
+	return var;
+}
+
+inline bool
+ScriptDocument::process(
+	char const* const begin,
+	char const* const end
+) {
+	m_scratch.clear();
+	if (m_parser.process_deferred(m_root, begin, end, m_scratch)) {
+		add_deferred(duct::aux::vector<std::size_t>{});
+		return true;
+	} else {
+		return false;
+	}
+}
+
+inline bool
+ScriptDocument::find_deferred(
+	Var const& var,
+	std::size_t& parent_index,
+	std::size_t& body_index
+) const {
+	std::less<Var const*> const less{};
+	for (parent_index = 0u; m_deferred.size() > parent_index; ++parent_index) {
+		auto const& parent = m_deferred[parent_index];
+		Var const* node = &m_root;
+		for (auto const position : parent.path) {
+			if (!node->is_type_of(VarMask::collection) || node->size() <= position) {
+				node = nullptr;
+				break;
+			}
+			node = &node->children()[position];
+		}
+		if (
+			nullptr == node ||
+			!node->is_type_of(VarMask::collection) ||
+			node->empty()
+		) {
+			continue;
+		}
+		auto const& children = node->children();
+		if (
+			less(&var, children.data()) ||
+			!less(&var, children.data() + children.size())
+		) {
+			continue;
+		}
+		std::size_t const position = static_cast<std::size_t>(&var - children.data());
+		auto const it = std::lower_bound(
+			parent.bodies.cbegin(), parent.bodies.cend(), position,
+			[](ScriptParser::DeferredNode const& body, std::size_t const value) {
+				return body.index < value;
+			}
+		);
+		if (parent.bodies.cend() != it && position == it->index) {
+			body_index = static_cast<std::size_t>(it - parent.bodies.cbegin());
+			return true;
+		}
+		return false;
+	}
+	return false;
+}
+
+inline void
+ScriptDocument::add_deferred(
+	duct::aux::vector<std::size_t> path
+) {
+	if (!m_scratch.empty()) {
+		m_unloaded += m_scratch.size();
+		m_deferred.push_back(DeferredParent{std::move(path), std::move(m_scratch)});
+		m_scratch.clear();
+	}
+}
+
+inline void
+ScriptDocument::load_tree(
+	Var& var
+) {
+	load(var);
+	if (var.is_type_of(VarMask::collection)) {
+		for (auto& child : var) {
+			load_tree(child);
+		}
+	}
+}
+
+} // namespace duct
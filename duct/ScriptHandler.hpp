@@ -0,0 +1,320 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief ductScript event handlers.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./debug.hpp"
+#include "./aux.hpp"
+#include "./CharBuf.hpp"
+#include "./Var.hpp"
+
+namespace duct {
+
+/**
+	@addtogroup ductScript
+	@{
+*/
+
+// Forward declarations
+class ScriptHandler;
+class ScriptVarBuilder;
+
+/**
+	ductScript event handler.
+
+	@note Events are sent by ScriptParser in document order. Every
+	collection begin event is matched by an end event unless an
+	exception is thrown. The root node is implicit; it has no events.
+
+	@note Names and values are given as character buffers which are
+	only valid for the duration of the event. A nameless collection or
+	value has an empty name.
+
+	@note All events are no-ops by default.
+*/
+class ScriptHandler {
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Default constructor. */
+	ScriptHandler() = default;
+	/** Copy constructor. */
+	ScriptHandler(ScriptHandler const&) = default;
+	/** Move constructor. */
+	ScriptHandler(ScriptHandler&&) = default;
+	/** Destructor. */
+	virtual
+	~ScriptHandler() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	ScriptHandler& operator=(ScriptHandler const&) = default;
+	/** Move assignment operator. */
+	ScriptHandler& operator=(ScriptHandler&&) = default;
+/// @}
+
+/** @name Events */ /// @{
+	/**
+		Node begin.
+
+		@param name Name.
+	*/
+	virtual void
+	on_node_begin(
+		CharBuf const& /*name*/
+	) {}
+
+	/**
+		Node end.
+	*/
+	virtual void
+	on_node_end() {}
+
+	/**
+		Identifier begin.
+
+		@param name Name.
+	*/
+	virtual void
+	on_identifier_begin(
+		CharBuf const& /*name*/
+	) {}
+
+	/**
+		Identifier end.
+	*/
+	virtual void
+	on_identifier_end() {}
+
+	/**
+		Array begin.
+
+		@param name Name.
+	*/
+	virtual void
+	on_array_begin(
+		CharBuf const& /*name*/
+	) {}
+
+	/**
+		Array end.
+	*/
+	virtual void
+	on_array_end() {}
+
+	/**
+		Value.
+
+		@note @a text is the unconverted value: the contents of
+		a string, the digits of a number, or the literal for
+		@c VarType::boolean (either @c "true" or @c "false") and
+		@c VarType::null.
+
+		@param name Name.
+		@param type Value type; one of @c VarType::string,
+		@c VarType::integer, @c VarType::decimal, @c VarType::boolean
+		and @c VarType::null.
+		@param text Value text.
+	*/
+	virtual void
+	on_value(
+		CharBuf const& /*name*/,
+		VarType const /*type*/,
+		CharBuf const& /*text*/
+	) {}
+/// @}
+};
+
+/**
+	ductScript event handler that builds a Var tree.
+
+	@note This is the handler used by the Var overloads of
+	ScriptParser::process().
+*/
+class ScriptVarBuilder final
+	: public ScriptHandler
+{
+private:
+	duct::aux::vector<Var*> m_stack{};
+	u8string m_name_buffer{};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Construct without root. */
+	ScriptVarBuilder() = default;
+
+	/**
+		Construct with root.
+
+		@param root Root node.
+		@sa reset(Var&)
+	*/
+	explicit
+	ScriptVarBuilder(
+		Var& root
+	) {
+		reset(root);
+	}
+
+	/** Copy constructor. */
+	ScriptVarBuilder(ScriptVarBuilder const&) = default;
+	/** Move constructor. */
+	ScriptVarBuilder(ScriptVarBuilder&&) = default;
+	/** Destructor. */
+	~ScriptVarBuilder() override = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	ScriptVarBuilder& operator=(ScriptVarBuilder const&) = default;
+	/** Move assignment operator. */
+	ScriptVarBuilder& operator=(ScriptVarBuilder&&) = default;
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Reset with root.
+
+		@param[out] root Root node; will be morphed to @c VarType::node
+		and existing children will not be removed.
+	*/
+	void
+	reset(
+		Var& root
+	) {
+		root.morph(VarType::node, false); // Make sure variable is a node
+		m_stack.clear();
+		m_stack.push_back(&root);
+	}
+/// @}
+
+/** @name Events */ /// @{
+	void
+	on_node_begin(
+		CharBuf const& name
+	) override {
+		begin(VarType::node, name);
+	}
+
+	void
+	on_node_end() override {
+		m_stack.pop_back();
+	}
+
+	void
+	on_identifier_begin(
+		CharBuf const& name
+	) override {
+		begin(VarType::identifier, name);
+	}
+
+	void
+	on_identifier_end() override {
+		m_stack.pop_back();
+	}
+
+	void
+	on_array_begin(
+		CharBuf const& name
+	) override {
+		begin(VarType::array, name);
+	}
+
+	void
+	on_array_end() override {
+		m_stack.pop_back();
+	}
+
+	void
+	on_value(
+		CharBuf const& name,
+		VarType const type,
+		CharBuf const& text
+	) override;
+/// @}
+
+private:
+	void
+	begin(
+		VarType const type,
+		CharBuf const& name
+	);
+};
+
+inline void
+ScriptVarBuilder::on_value(
+	CharBuf const& name,
+	VarType const type,
+	CharBuf const& text
+) {
+	DUCT_DEBUG_ASSERTP(
+		!m_stack.empty(), this,
+		"reset() must be called first"
+	);
+	auto& coll = *m_stack.back();
+	// Named on construction; renaming would bump Var::name_generation()
+	detail::var_config::name_type var_name{};
+	if (!name.empty()) {
+		name.to_string(m_name_buffer);
+		var_name = detail::var_config::name_type{m_name_buffer};
+	}
+	switch (type) {
+	case VarType::string:
+		coll.emplace_back(
+			std::move(var_name),
+			text.to_string<detail::var_config::string_type>()
+		); break;
+
+	case VarType::integer:
+		coll.emplace_back(
+			std::move(var_name),
+			text.to_arithmetic<detail::var_config::integer_type>()
+		); break;
+
+	case VarType::decimal:
+		coll.emplace_back(
+			std::move(var_name),
+			text.to_arithmetic<detail::var_config::decimal_type>()
+		); break;
+
+	case VarType::boolean:
+		// The literal is either "true" or "false"
+		coll.emplace_back(std::move(var_name), 4u == text.size());
+		break;
+
+	default:
+		coll.emplace_back(std::move(var_name), VarType::null);
+		break;
+	}
+}
+
+inline void
+ScriptVarBuilder::begin(
+	VarType const type,
+	CharBuf const& name
+) {
+	DUCT_DEBUG_ASSERTP(
+		!m_stack.empty(), this,
+		"reset() must be called first"
+	);
+	auto& coll = *m_stack.back();
+	if (name.empty()) {
+		coll.emplace_back(type);
+	} else {
+		name.to_string(m_name_buffer);
+		coll.emplace_back(
+			detail::var_config::name_type{m_name_buffer},
+			type
+		);
+	}
+	m_stack.push_back(&coll.back());
+}
+
+/** @} */ // end of doc-group ductScript
+
+} // namespace duct
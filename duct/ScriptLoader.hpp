@@ -0,0 +1,280 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief ScriptLoader class.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./aux.hpp"
+#include "./string.hpp"
+#include "./Var.hpp"
+#include "./ScriptParser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace duct {
+
+// Forward declarations
+class ScriptLoader;
+
+/**
+	@addtogroup ductScript
+	@{
+*/
+
+/**
+	ductScript batch loader.
+
+	@note Files are processed concurrently by a number of worker
+	threads, each of which reuses its own ScriptParser. Each worker
+	takes the next unprocessed file until none remain, so many small
+	files are balanced across workers. Results are stored in the same
+	order as the paths regardless of which worker processed a file.
+*/
+class ScriptLoader final {
+public:
+/** @name Types */ /// @{
+	/**
+		Load status.
+	*/
+	enum class Status : unsigned {
+		/** File was processed. */
+		success,
+		/** File could not be opened. */
+		file_error,
+		/** File could not be processed (see Result::error). */
+		parse_error
+	};
+
+	/**
+		Load result.
+	*/
+	struct Result final {
+		/** Root node; empty unless status is Status::success. */
+		Var root{VarType::node};
+		/** Status. */
+		Status status{Status::success};
+		/** Error message if status is Status::parse_error. */
+		u8string error{};
+	};
+/// @}
+
+private:
+	duct::aux::vector<ScriptParser> m_parsers{};
+	ScriptParser::Lexer m_lexer{ScriptParser::Lexer::standard};
+	unsigned m_thread_count;
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/**
+		Construct with thread count.
+
+		@param thread_count Maximum number of worker threads; @c 0 to
+		use @c std::thread::hardware_concurrency().
+	*/
+	explicit
+	ScriptLoader(
+		unsigned const thread_count = 0u
+	) noexcept
+		: m_thread_count(
+			0u != thread_count
+			? thread_count
+			: std::thread::hardware_concurrency()
+		)
+	{
+		if (0u == m_thread_count) {
+			m_thread_count = 1u;
+		}
+	}
+
+	/** Copy constructor (deleted). */
+	ScriptLoader(ScriptLoader const&) = delete;
+	/** Move constructor. */
+	ScriptLoader(ScriptLoader&&) = default;
+	/** Destructor. */
+	~ScriptLoader() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator (deleted). */
+	ScriptLoader& operator=(ScriptLoader const&) = delete;
+	/** Move assignment operator. */
+	ScriptLoader& operator=(ScriptLoader&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Get thread count.
+
+		@returns The maximum number of worker threads.
+	*/
+	unsigned
+	thread_count() const noexcept {
+		return m_thread_count;
+	}
+
+	/**
+		Set lexer.
+
+		@param lexer Lexer for workers to use.
+	*/
+	void
+	set_lexer(
+		ScriptParser::Lexer const lexer
+	) noexcept {
+		m_lexer = lexer;
+	}
+
+	/**
+		Get lexer.
+	*/
+	ScriptParser::Lexer
+	lexer() const noexcept {
+		return m_lexer;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Process files.
+
+		@note Errors are reported per file; an error in one file does
+		not affect the others.
+
+		@note If a worker thread cannot be started, the files are
+		shared by those that were. Other exceptions (such as
+		@c std::bad_alloc) are rethrown once every worker has
+		finished.
+
+		@param paths Paths of files to process.
+		@param[out] results Results; one per path, in the same order
+		as @a paths. Existing results are removed.
+	*/
+	void
+	process(
+		duct::aux::vector<u8string> const& paths,
+		duct::aux::vector<Result>& results
+	);
+
+	/**
+		Process files.
+
+		@returns Results; one per path, in the same order as @a paths.
+		@param paths Paths of files to process.
+	*/
+	duct::aux::vector<Result>
+	process(
+		duct::aux::vector<u8string> const& paths
+	) {
+		duct::aux::vector<Result> results{};
+		process(paths, results);
+		return results;
+	}
+/// @}
+
+private:
+	static void
+	process_file(
+		ScriptParser& parser,
+		u8string const& path,
+		Result& result
+	);
+};
+
+/** @} */ // end of doc-group ductScript
+
+inline void
+ScriptLoader::process(
+	duct::aux::vector<u8string> const& paths,
+	duct::aux::vector<Result>& results
+) {
+	results.clear();
+	results.resize(paths.size());
+	unsigned const workers = static_cast<unsigned>(std::min<std::size_t>(
+		m_thread_count, paths.size()
+	));
+	while (workers > m_parsers.size()) {
+		m_parsers.emplace_back();
+	}
+	for (auto& parser : m_parsers) {
+		parser.set_lexer(m_lexer);
+	}
+
+	std::atomic<std::size_t> next{0u};
+	auto const worker = [&](ScriptParser& parser) {
+		for (std::size_t i; paths.size() > (i = next++);) {
+			process_file(parser, paths[i], results[i]);
+		}
+	};
+	// Exceptions from other threads are rethrown after joining
+	duct::aux::vector<std::exception_ptr> errors(workers);
+	auto const thread_worker = [&](unsigned const index) {
+		try {
+			worker(m_parsers[index]);
+		} catch (...) {
+			errors[index] = std::current_exception();
+		}
+	};
+	duct::aux::vector<std::thread> threads{};
+	threads.reserve(workers);
+	try {
+		for (unsigned index = 1u; workers > index; ++index) {
+			threads.emplace_back(thread_worker, index);
+		}
+	} catch (std::system_error&) {
+		// Continue with the threads that started
+	}
+	try {
+		if (0u < workers) {
+			worker(m_parsers[0u]);
+		}
+	} catch (...) {
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		throw;
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (auto const& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+inline void
+ScriptLoader::process_file(
+	ScriptParser& parser,
+	u8string const& path,
+	Result& result
+) {
+	try {
+		if (parser.process_file(result.root, path)) {
+			result.status = Status::success;
+		} else {
+			result.status = Status::file_error;
+		}
+	} catch (std::exception& e) {
+		// Usually ScriptParserException, which refers to the parser
+		// and can't be kept
+		result.status = Status::parse_error;
+		result.error.assign(e.what());
+		parser.reset();
+	}
+	if (Status::success != result.status) {
+		result.root = Var{VarType::node};
+	}
+}
+
+} // namespace duct
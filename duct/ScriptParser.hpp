@@ -10,20 +10,28 @@
 #include "./config.hpp"
 #include "./debug.hpp"
 #include "./aux.hpp"
+#include "./Arena.hpp"
 #include "./char.hpp"
 #include "./utility.hpp"
 #include "./StateStore.hpp"
 #include "./CharacterSet.hpp"
+#include "./CompiledCharacterSet.hpp"
 #include "./StringUtils.hpp"
+#include "./IO/MappedFile.hpp"
 #include "./Parser.hpp"
+#include "./ScriptHandler.hpp"
 #include "./Var.hpp"
 #include "./VarUtils.hpp"
 
 #include <cstdio>
 #include <cstdarg>
+#include <algorithm>
 #include <utility>
 #include <exception>
 #include <type_traits>
+#include <atomic>
+#include <system_error>
+#include <thread>
 
 namespace duct {
 
@@ -104,6 +112,47 @@ public:
 class ScriptParser final
 	: public Parser
 {
+public:
+/** @name Types */ /// @{
+	/**
+		Lexers.
+	*/
+	enum class Lexer : unsigned {
+		/** Code point-driven lexer. */
+		standard = 0u,
+		/**
+			Table-driven lexer.
+
+			@note Only used for source buffers (streams use
+			Lexer::standard). Runs of plain bytes are consumed in bulk
+			by a byte-class table and a transition table; the token
+			stream is identical to that of Lexer::standard.
+		*/
+		table
+	};
+
+	/**
+		Deferred node body.
+
+		@sa process_deferred(Var&, char const*, char const*, deferred_vector_type&)
+	*/
+	struct DeferredNode final {
+		/** Index of the node in its parent. */
+		std::size_t index;
+		/** Beginning of body (after the open-brace). */
+		char const* begin;
+		/** End of body (after the close-brace). */
+		char const* end;
+		/** Line of the beginning of the body. */
+		signed line;
+		/** Column of the beginning of the body. */
+		signed column;
+	};
+
+	/** Deferred node vector. */
+	using deferred_vector_type = duct::aux::vector<DeferredNode>;
+/// @}
+
 private:
 	enum class State : unsigned {
 		equals = bit(0),
@@ -111,9 +160,51 @@ private:
 		open_array = bit(2)
 	};
 
-	duct::aux::deque<Var*> m_stack{32u};
+	// Lexical state of scanned data (see feed())
+	enum class ScanState : unsigned {
+		normal,
+		slash,
+		escape,
+		quoted,
+		quoted_escape,
+		comment,
+		comment_block,
+		comment_block_star
+	};
+
+	enum class ScanEvent : unsigned {
+		none,
+		// Whitespace between tokens
+		blank,
+		newline,
+		// Open or close brace or bracket
+		open,
+		close
+	};
+
+	// Result of process_chunk()
+	enum class ChunkResult : unsigned {
+		error,
+		// Ended within a statement or collection
+		open,
+		// Ended in root scope
+		closed
+	};
+
+	duct::aux::vector<VarType> m_stack{};
+	ScriptHandler* m_handler{nullptr};
+	ScriptVarBuilder m_builder{};
 	StateStore<State> m_states{};
 	Token m_token_ident{NULL_TOKEN, 128u};
+	Lexer m_lexer{Lexer::standard};
+	Arena* m_arena{nullptr};
+	duct::aux::vector<char> m_feed_buffer{};
+	std::size_t m_feed_scanned{0u};
+	ScanState m_feed_state{ScanState::normal};
+	bool m_feeding{false};
+	deferred_vector_type* m_deferred{nullptr};
+	std::size_t m_defer_depth{0u};
+	std::size_t m_defer_count{0u};
 
 public:
 /** @name Constructors and destructor */ /// @{
@@ -147,6 +238,57 @@ public:
 	ScriptParser& operator=(ScriptParser&&) = default;
 /// @}
 
+/** @name Properties */ /// @{
+	/**
+		Set lexer.
+
+		@param lexer Lexer to use.
+	*/
+	void
+	set_lexer(
+		Lexer const lexer
+	) noexcept {
+		m_lexer = lexer;
+	}
+
+	/**
+		Get lexer.
+	*/
+	Lexer
+	lexer() const noexcept {
+		return m_lexer;
+	}
+
+	/**
+		Set arena.
+
+		@note While processing, the arena is made current (see
+		Arena::Scope), so with ArenaAllocator as
+		#DUCT_CONFIG_ALLOCATOR, the values and collections that are
+		built are allocated from it and freed when it is released.
+		The parser's own buffers are not allocated from the arena.
+
+		@warning The arena must outlive the built values.
+
+		@param arena Arena; @c nullptr (the default) to use the
+		current arena.
+	*/
+	void
+	set_arena(
+		Arena* const arena
+	) noexcept {
+		m_arena = arena;
+	}
+
+	/**
+		Get arena.
+	*/
+	Arena*
+	arena() const noexcept {
+		return m_arena;
+	}
+/// @}
+
 /** @name State */ /// @{
 	void
 	reset() noexcept override;
@@ -180,8 +322,277 @@ public:
 	process(
 		Var& node,
 		std::istream& stream
+	) {
+		m_builder.reset(node);
+		return process(static_cast<ScriptHandler&>(m_builder), stream);
+	}
+
+	/**
+		Process a stream with an event handler.
+
+		@note No Var tree is built; @a handler receives the events for
+		the document as it is parsed.
+
+		@returns @c true on success.
+		@param handler Event handler.
+		@param stream Stream to process.
+	*/
+	bool
+	process(
+		ScriptHandler& handler,
+		std::istream& stream
+	);
+
+	/**
+		Process a UTF-8 source buffer.
+
+		@note The grammar and error messages are identical to those of
+		@c process(Var&, std::istream&), but the buffer is decoded
+		directly instead of through the parser's StreamContext.
+
+		@warning The state of @a node is undefined if either @c false
+		is returned or if an exception is thrown whilst processing.
+
+		@returns @c true on success.
+		@param[out] node Output node; will be morphed
+		to @c VarType::node and existing children will not be removed.
+		@param begin Beginning of source buffer.
+		@param end End of source buffer.
+	*/
+	bool
+	process(
+		Var& node,
+		char const* const begin,
+		char const* const end
+	) {
+		m_builder.reset(node);
+		return process(static_cast<ScriptHandler&>(m_builder), begin, end);
+	}
+
+	/**
+		Process a UTF-8 source buffer with an event handler.
+
+		@returns @c true on success.
+		@param handler Event handler.
+		@param begin Beginning of source buffer.
+		@param end End of source buffer.
+		@sa process(ScriptHandler&, std::istream&)
+	*/
+	bool
+	process(
+		ScriptHandler& handler,
+		char const* const begin,
+		char const* const end
 	);
 
+	/**
+		Process a UTF-8 file.
+
+		@note The file is memory-mapped and parsed in place
+		(see IO::MappedFile).
+
+		@warning The state of @a node is undefined if either @c false
+		is returned or if an exception is thrown whilst processing.
+
+		@returns @c true on success; @c false if the file could not
+		be mapped.
+		@param[out] node Output node; will be morphed
+		to @c VarType::node and existing children will not be removed.
+		@param path Path of file to process.
+	*/
+	bool
+	process_file(
+		Var& node,
+		char const* const path
+	) {
+		m_builder.reset(node);
+		return process_file(static_cast<ScriptHandler&>(m_builder), path);
+	}
+
+	/** @copydoc process_file(Var&, char const*) */
+	bool
+	process_file(
+		Var& node,
+		u8string const& path
+	) {
+		return process_file(node, path.c_str());
+	}
+
+	/**
+		Process a UTF-8 file with an event handler.
+
+		@returns @c true on success; @c false if the file could not
+		be mapped.
+		@param handler Event handler.
+		@param path Path of file to process.
+		@sa process(ScriptHandler&, std::istream&)
+	*/
+	bool
+	process_file(
+		ScriptHandler& handler,
+		char const* const path
+	);
+
+	/** @copydoc process_file(ScriptHandler&, char const*) */
+	bool
+	process_file(
+		ScriptHandler& handler,
+		u8string const& path
+	) {
+		return process_file(handler, path.c_str());
+	}
+
+	/**
+		Process a UTF-8 source buffer, deferring node bodies.
+
+		@note The bodies of nodes which are direct children of @a node
+		are not processed; the nodes are left empty and their bodies
+		are added to @a deferred, to be processed on demand by
+		process_deferred(Var&, DeferredNode const&, deferred_vector_type&).
+		A body is found by scanning for the matching close-brace
+		(outside of quoted strings and comments), so errors within it
+		are only reported when it is processed. If there is no
+		matching close-brace, the node is processed normally.
+
+		@warning The source buffer must outlive the deferred bodies.
+
+		@returns @c true on success.
+		@param[out] node Output node; will be morphed
+		to @c VarType::node and existing children will not be removed.
+		@param begin Beginning of source buffer.
+		@param end End of source buffer.
+		@param[out] deferred Deferred node bodies are appended to this.
+	*/
+	bool
+	process_deferred(
+		Var& node,
+		char const* const begin,
+		char const* const end,
+		deferred_vector_type& deferred
+	);
+
+	/**
+		Process a deferred node body.
+
+		@note Errors are reported as they would have been by
+		processing the body in place. The bodies of the node's own
+		child nodes are deferred.
+
+		@param[out] node Output node (normally the node whose body was
+		deferred); will be morphed to @c VarType::node and existing
+		children will not be removed.
+		@param body Deferred body.
+		@param[out] deferred Deferred node bodies are appended to this.
+	*/
+	void
+	process_deferred(
+		Var& node,
+		DeferredNode const& body,
+		deferred_vector_type& deferred
+	);
+
+	/**
+		Process a UTF-8 source buffer in parallel.
+
+		@note The buffer is split at newlines in root scope (outside
+		of quoted strings, comments and collections) into chunks, which
+		are processed by worker threads; their values are then moved
+		into @a node in order. A chunk that did not end in a clean
+		root state (e.g. within an identifier) is processed again
+		together with the following chunk. The result is identical to
+		that of @c process(Var&, char const*, char const*); if any
+		chunk has an error, the whole buffer is processed sequentially
+		so that the error is reported identically.
+
+		@note Small buffers are processed sequentially. An Arena is not
+		thread-safe, so worker threads never allocate from one; if an
+		arena is set (see set_arena()) or current (see Arena::current()),
+		the buffer is processed sequentially in it. If a worker thread
+		cannot be started, the chunks are shared by those that were.
+
+		@warning The state of @a node is undefined if either @c false
+		is returned or if an exception is thrown whilst processing.
+
+		@returns @c true on success.
+		@param[out] node Output node; will be morphed
+		to @c VarType::node and existing children will not be removed.
+		@param begin Beginning of source buffer.
+		@param end End of source buffer.
+		@param thread_count Maximum number of worker threads; @c 0 to
+		use @c std::thread::hardware_concurrency().
+	*/
+	bool
+	process_parallel(
+		Var& node,
+		char const* const begin,
+		char const* const end,
+		unsigned thread_count = 0u
+	);
+
+	/**
+		Begin processing fed data.
+
+		@note Data is given to the parser with feed() and processing
+		is completed with end_feed(). The result is identical to
+		processing all of the data at once with
+		@c process(Var&, char const*, char const*).
+
+		@warning The state of @a node is undefined if an exception is
+		thrown whilst processing.
+
+		@param[out] node Output node; will be morphed
+		to @c VarType::node and existing children will not be removed.
+	*/
+	void
+	begin_feed(
+		Var& node
+	) {
+		m_builder.reset(node);
+		begin_feed(static_cast<ScriptHandler&>(m_builder));
+	}
+
+	/**
+		Begin processing fed data with an event handler.
+
+		@param handler Event handler.
+		@sa begin_feed(Var&), process(ScriptHandler&, std::istream&)
+	*/
+	void
+	begin_feed(
+		ScriptHandler& handler
+	);
+
+	/**
+		Feed UTF-8 data.
+
+		@note Data can be split anywhere, including within code
+		points, escape sequences, comments and quoted strings. Fed data
+		is parsed up to the last whitespace that separates tokens and
+		the rest is retained until more data is fed, so memory use is
+		bounded by the longest run of data without such a split point
+		(generally the longest token or comment).
+
+		@warning begin_feed() must be called first.
+
+		@param data Data.
+		@param size Size of @a data in bytes.
+	*/
+	void
+	feed(
+		char const* const data,
+		std::size_t const size
+	);
+
+	/**
+		Finish processing fed data.
+
+		@note The parser is reset.
+
+		@warning begin_feed() must be called first.
+	*/
+	void
+	end_feed();
+
 	bool
 	parse() override;
 
@@ -196,6 +607,48 @@ public:
 /// @}
 
 private:
+	void
+	process_all(
+		ScriptHandler& handler
+	);
+
+	void
+	end_process();
+
+	static ScanEvent
+	scan_char(
+		ScanState& state,
+		char32 const cp
+	) noexcept;
+
+	std::size_t
+	scan_feed();
+
+	void
+	count_child() noexcept {
+		if (m_defer_depth == m_stack.size()) {
+			++m_defer_count;
+		}
+	}
+
+	void
+	defer_node();
+
+	static duct::aux::vector<char const*>
+	split_source(
+		char const* const begin,
+		char const* const end,
+		std::size_t const chunk_count
+	);
+
+	ChunkResult
+	process_chunk(
+		Var& node,
+		char const* const* const splits,
+		std::size_t& count,
+		bool const final
+	) noexcept;
+
 	void
 	read_tok_integer();
 
@@ -212,7 +665,19 @@ private:
 	read_tok_string();
 
 	void
-	read_tok_string_quoted();
+	read_tok_string_quoted(
+		bool const resume = false
+	);
+
+	void
+	read_tok_table(
+		unsigned state
+	);
+
+	bool
+	use_table_lexer() const noexcept {
+		return Lexer::table == m_lexer && has_source();
+	}
 
 	void
 	read_tok_comment_block();
@@ -224,7 +689,7 @@ private:
 	in_scope(
 		VarMask const mask
 	) noexcept {
-		return current_collection().is_type_of(mask);
+		return var_type_is_of(current_scope(), mask);
 	}
 
 	bool
@@ -234,17 +699,28 @@ private:
 		return in_scope(static_cast<VarMask>(type));
 	}
 
-	Var&
-	current_collection() noexcept;
+	VarType
+	current_scope() const noexcept;
 
 	void
 	push(
-		Var& collection
+		VarType const type
 	);
 
 	void
 	pop();
 
+	void
+	begin_collection(
+		VarType const type,
+		CharBuf const& name
+	);
+
+	void
+	end_collection(
+		VarType const type
+	);
+
 	void
 	throwex(
 		ScriptParserException&& e
@@ -14,6 +14,7 @@
 #include "./detail/string_traits.hpp"
 #include "./StateStore.hpp"
 #include "./CharacterSet.hpp"
+#include "./CompiledCharacterSet.hpp"
 #include "./EncodingUtils.hpp"
 #include "./StringUtils.hpp"
 #include "./IO/StreamContext.hpp"
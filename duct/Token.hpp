@@ -14,6 +14,7 @@ namespace duct {
 
 // Forward declarations
 class Token;
+class Parser;
 
 /**
 	@addtogroup parser
@@ -31,8 +32,11 @@ enum : signed {
 class Token {
 protected:
 	signed m_type{NULL_TOKEN}; /**< Type. */
-	signed m_line{-1}; /**< Line position. */
-	signed m_column{-1}; /**< Column position. */
+	mutable signed m_line{-1}; /**< Line position. */
+	mutable signed m_column{-1}; /**< Column position. */
+	char const* m_source{nullptr}; /**< Source position. */
+	/** Parser to resolve the source position with (see line()). */
+	mutable Parser const* m_parser{nullptr};
 	CharBuf m_buffer{}; /**< Character buffer. */
 
 public:
@@ -107,6 +111,8 @@ public:
 	/**
 		Set position.
 
+		@note This clears the source position.
+
 		@param line New line position.
 		@param column New column position.
 	*/
@@ -117,6 +123,44 @@ public:
 	) noexcept {
 		m_line = line;
 		m_column = column;
+		m_source = nullptr;
+		m_parser = nullptr;
+	}
+
+	/**
+		Set source position.
+
+		@note The line and column of a token read from a source buffer
+		are computed from its source position by @a parser when they
+		are first requested (see line()).
+
+		@param source Position of the token in the parser's source
+		buffer; @c nullptr if the token is positioned by line and
+		column.
+		@param parser Parser that read the token.
+	*/
+	void
+	set_source(
+		char const* const source,
+		Parser const* const parser
+	) noexcept {
+		m_source = source;
+		m_parser = (nullptr != source) ? parser : nullptr;
+		if (nullptr != source) {
+			m_line = -1;
+			m_column = -1;
+		}
+	}
+
+	/**
+		Get source position.
+
+		@returns The source position, or @c nullptr if the token is
+		positioned by line and column.
+	*/
+	char const*
+	source() const noexcept {
+		return m_source;
 	}
 
 	/**
@@ -128,16 +172,23 @@ public:
 	set_line(
 		signed const line
 	) noexcept {
+		resolve_source();
 		m_line = line;
 	}
 
 	/**
 		Get line position.
 
+		@note For a token with a source position (see source()), the
+		line and column are resolved by the parser that read it on the
+		first request. That parser must still be reading the same input
+		(or have resolved the position); otherwise they are @c -1.
+
 		@returns The current line position.
 	*/
 	signed
 	line() const noexcept {
+		resolve_source();
 		return m_line;
 	}
 
@@ -150,16 +201,21 @@ public:
 	set_column(
 		signed const column
 	) noexcept {
+		resolve_source();
 		m_column = column;
 	}
 
 	/**
 		Get column position.
 
+		@note A token with a source position is resolved as with
+		line().
+
 		@returns The current column position.
 	*/
 	signed
 	column() const noexcept {
+		resolve_source();
 		return m_column;
 	}
 
@@ -241,8 +297,16 @@ public:
 		}
 	}
 /// @}
+
+private:
+	// Defined after Parser
+	inline void
+	resolve_source() const noexcept;
 };
 
 /** @} */ // end of doc-group parser
 
 } // namespace duct
+
+// Token::resolve_source() needs Parser
+#include "./Parser.hpp"
@@ -14,14 +14,21 @@
 #include "./utility.hpp"
 #include "./VarType.hpp"
 #include "./detail/var.hpp"
+#include "./detail/hash.hpp"
 #include "./StringUtils.hpp"
 
+#include <new>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 
 namespace duct {
 
 // Forward declarations
 class Var;
+class VarPath;
 
 /**
 	@addtogroup var
@@ -31,10 +38,14 @@ class Var;
 /**
 	Multi-type variable.
 
-	@warning This class is relatively heavy since it serves the
-	purposes of every variable type — use it wisely.
+	@note The string value and the child collection are stored out of
+	line, sharing storage with the numeric values; they are only
+	allocated once they are non-empty. A variable is otherwise the
+	size of its name plus two words.
 */
 class Var final {
+	friend class VarPath;
+
 public:
 /** @name Types */ /// @{
 	/** Children vector. */
@@ -48,20 +59,352 @@ public:
 /// @}
 
 private:
-	VarType m_type{VarType::null};
+	// Name hash table over a child collection. Positions are
+	// one-based; 0 marks an empty slot. Linear probing keeps equal
+	// names in position order.
+	struct IndexSlot final {
+		std::uint32_t hash;
+		std::uint32_t position;
+	};
+
+	struct Index final {
+		using allocator_type = aux::vector<IndexSlot>::allocator_type;
+
+		aux::vector<IndexSlot> slots{};
+		std::size_t count{0u};
+		// Name generation the index was last checked at
+		std::atomic<std::uint64_t> generation{0u};
+
+		Index() = default;
+		Index(Index const&) = delete;
+		Index& operator=(Index const&) = delete;
+
+		allocator_type
+		get_allocator() const noexcept {
+			return slots.get_allocator();
+		}
+	};
+
+	enum : std::uint32_t {
+		// A lookup is rebuilding the index
+		lookup_rebuilding = 0x80000000u,
+		// A lookup found the index stale while others were reading
+		// it; the first lookup after them rebuilds it
+		lookup_stale = 0x40000000u,
+	};
+
+	struct Collection final {
+		using allocator_type = vector_type::allocator_type;
+
+		vector_type children;
+		Index* index{nullptr};
+		// Number of const lookups reading index, and the lookup_*
+		// flags. A lookup that finds the index stale rebuilds it in
+		// place only if no other lookup is reading it.
+		std::atomic<std::uint32_t> lookups{0u};
+		// Set by non-const children(): the children may be changed
+		// without the index following, so lookups scan them
+		bool exposed{false};
+	#if (0 != DUCT_CONFIG_VAR_COPY_ON_WRITE)
+		// Number of Vars sharing the collection
+		std::atomic<std::uint32_t> refs{1u};
+	#endif
+
+		template<class... ArgP>
+		explicit
+		Collection(
+			ArgP&&... args
+		)
+			: children(std::forward<ArgP>(args)...)
+		{}
+
+		Collection(Collection const&) = delete;
+		Collection& operator=(Collection const&) = delete;
+
+		~Collection() {
+			free_box(index);
+		}
+
+		allocator_type
+		get_allocator() const noexcept {
+			return children.get_allocator();
+		}
+	};
+
 	detail::var_config::name_type m_name{};
-	vector_type m_children{};
-	detail::var_config::string_type m_strv{};
 
-	// NB: union is zero-initialized.
-	// GCC 4.7.0 (and probably other versions) has a defect which does
-	// not allow a ctor to be `=default` when a union member is
-	// aggregate-intialized.
+	// Storage is selected by m_type. m_strv and m_collection are
+	// nullptr when empty; m_bits zero-initializes the union.
 	union {
+		std::uint64_t m_bits{0u};
 		detail::var_config::integer_type m_integer;
 		detail::var_config::decimal_type m_decimal;
 		detail::var_config::boolean_type m_boolean;
+		detail::var_config::string_type* m_strv;
+		Collection* m_collection;
 	};
+	VarType m_type{VarType::null};
+
+	// Boxes are allocated with (a rebind of) their own allocator, so
+	// that they are freed by the allocator they were allocated with
+	template<class T>
+	using box_allocator = typename std::allocator_traits<
+		typename T::allocator_type
+	>::template rebind_alloc<T>;
+
+	template<class T, class... ArgP>
+	static T*
+	make_box(
+		ArgP&&... args
+	) {
+		box_allocator<T> allocator{};
+		T* const box = allocator.allocate(1u);
+		try {
+			::new(static_cast<void*>(box)) T(std::forward<ArgP>(args)...);
+		} catch (...) {
+			allocator.deallocate(box, 1u);
+			throw;
+		}
+		return box;
+	}
+
+	template<class T>
+	static void
+	free_box(
+		T* const box
+	) noexcept {
+		if (nullptr != box) {
+			box_allocator<T> allocator{box->get_allocator()};
+			box->~T();
+			allocator.deallocate(box, 1u);
+		}
+	}
+
+	static detail::var_config::string_type const&
+	empty_string() noexcept {
+		static detail::var_config::string_type const s_empty{};
+		return s_empty;
+	}
+
+	static vector_type&
+	empty_children() noexcept {
+		// Never modified; only its (equal) iterators are handed out
+		static vector_type s_empty{};
+		return s_empty;
+	}
+
+	// Free the string value or child collection, if any
+	void
+	release() noexcept {
+		switch (m_type) {
+		case VarType::string: free_box(m_strv); break;
+		case VarType::array:
+		case VarType::node:
+		case VarType::identifier:
+			release_collection(m_collection);
+			break;
+		default:
+			break;
+		}
+		m_bits = 0u;
+	}
+
+	static void
+	release_collection(
+		Collection* const collection
+	) noexcept {
+	#if (0 != DUCT_CONFIG_VAR_COPY_ON_WRITE)
+		if (
+			nullptr != collection &&
+			1u != collection->refs.fetch_sub(1u, std::memory_order_acq_rel)
+		) {
+			return;
+		}
+	#endif
+		free_box(collection);
+	}
+
+	// Whether the collection is shared with other Vars, and so must
+	// not be modified
+	bool
+	shared_collection() const noexcept {
+	#if (0 != DUCT_CONFIG_VAR_COPY_ON_WRITE)
+		return
+			nullptr != m_collection &&
+			1u != m_collection->refs.load(std::memory_order_acquire)
+		;
+	#else
+		return false;
+	#endif
+	}
+
+	// Take a copy of a shared collection before it is modified. The
+	// copy shares the children's own collections, so this is linear
+	// in the number of children, not in the size of the subtree.
+	void
+	detach() {
+		if (shared_collection()) {
+			Collection* const copy = make_box<Collection>(m_collection->children);
+			release_collection(m_collection);
+			m_collection = copy;
+		}
+	}
+
+	// Drop a shared collection that is about to be replaced
+	void
+	detach_empty() noexcept {
+		if (shared_collection()) {
+			release_collection(m_collection);
+			m_collection = nullptr;
+		}
+	}
+
+	vector_type&
+	children_box() {
+		detach();
+		if (nullptr == m_collection) {
+			m_collection = make_box<Collection>();
+		}
+		return m_collection->children;
+	}
+
+	vector_type&
+	children_view() {
+		detach();
+		return
+			(nullptr != m_collection)
+			? m_collection->children
+			: empty_children()
+		;
+	}
+
+	vector_type const&
+	children_view_const() const noexcept {
+		return children_view();
+	}
+
+	vector_type const&
+	children_view() const noexcept {
+		return
+			(nullptr != m_collection)
+			? m_collection->children
+			: empty_children()
+		;
+	}
+
+	static std::atomic<std::uint64_t>&
+	name_generation_ref() noexcept {
+		static std::atomic<std::uint64_t> s_generation{0u};
+		return s_generation;
+	}
+
+	static void
+	bump_name_generation() noexcept {
+		name_generation_ref().fetch_add(1u, std::memory_order_relaxed);
+	}
+
+	static std::uint32_t
+	hash_name(
+		char const* const data,
+		std::size_t const size
+	) noexcept {
+		return detail::fnv1a<std::uint32_t>(data, size);
+	}
+
+	static bool
+	name_equals(
+		Var const& var,
+		char const* const data,
+		std::size_t const size
+	) noexcept {
+		auto const& name = var.m_name;
+		return
+			size == name.size() &&
+			0 == std::memcmp(name.data(), data, size)
+		;
+	}
+
+	// Drop the child index after a change to the collection that the
+	// index does not follow
+	void
+	drop_index() noexcept {
+		if (nullptr != m_collection) {
+			free_box(m_collection->index);
+			m_collection->index = nullptr;
+			m_collection->lookups.store(0u, std::memory_order_relaxed);
+			m_collection->exposed = false;
+		}
+	}
+
+	// A lookup's hold on its collection's index
+	struct IndexLease final {
+		Collection& collection;
+
+		~IndexLease() {
+			collection.lookups.fetch_sub(1u, std::memory_order_release);
+		}
+	};
+
+	static void
+	index_insert(
+		Index& index,
+		std::uint32_t const hash,
+		std::size_t const position
+	) noexcept {
+		std::size_t const mask = index.slots.size() - 1u;
+		std::size_t i = hash & mask;
+		while (0u != index.slots[i].position) {
+			i = (i + 1u) & mask;
+		}
+		index.slots[i] = {hash, static_cast<std::uint32_t>(position + 1u)};
+		++index.count;
+	}
+
+	static void
+	index_fill(
+		Index& index,
+		vector_type const& children,
+		std::uint64_t const generation
+	);
+
+	static bool
+	index_verify(
+		Index const& index,
+		vector_type const& children
+	) noexcept;
+
+	static void
+	index_rebuild(
+		Collection& collection
+	);
+
+	static void
+	index_append(
+		Collection& collection
+	);
+
+	static Index const*
+	index_rebuild_shared(
+		Collection& collection,
+		std::uint64_t const generation
+	);
+
+	// Enter a lookup on the index, rebuilding it if it is stale. If
+	// this returns nullptr, the lookup was not entered and must scan
+	// the collection instead.
+	static Index const*
+	index_acquire(
+		Collection& collection
+	);
+
+	template<class F>
+	void
+	find_each(
+		char const* const data,
+		std::size_t const size,
+		std::uint32_t const hash,
+		F&& f
+	) const;
 
 public:
 /** @name Constructors and operators */ /// @{
@@ -80,8 +423,8 @@ public:
 		detail::var_config::name_type name,
 		VarType const type
 	)
-		: m_type(type)
-		, m_name(std::move(name))
+		: m_name(std::move(name))
+		, m_type(type)
 	{}
 
 	/**
@@ -111,9 +454,11 @@ public:
 		initializer_list_type ilist
 	)
 		: m_type(type)
-		, m_children(std::move(ilist))
 	{
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
+		if (0u != ilist.size()) {
+			m_collection = make_box<Collection>(ilist);
+		}
 	}
 
 	/**
@@ -132,11 +477,13 @@ public:
 		VarType const type,
 		initializer_list_type ilist
 	)
-		: m_type(type)
-		, m_name(std::move(name))
-		, m_children(std::move(ilist))
+		: m_name(std::move(name))
+		, m_type(type)
 	{
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
+		if (0u != ilist.size()) {
+			m_collection = make_box<Collection>(ilist);
+		}
 	}
 
 	/**
@@ -149,10 +496,11 @@ public:
 		detail::var_config::name_type name,
 		detail::var_config::string_type value
 	)
-		: m_type(VarType::string)
-		, m_name(std::move(name))
-		, m_strv(std::move(value))
-	{}
+		: m_name(std::move(name))
+		, m_type(VarType::string)
+	{
+		assign(std::move(value));
+	}
 
 	/**
 		Construct nameless @c VarType::string with value.
@@ -164,8 +512,9 @@ public:
 		detail::var_config::string_type value
 	)
 		: m_type(VarType::string)
-		, m_strv(std::move(value))
-	{}
+	{
+		assign(std::move(value));
+	}
 
 	/**
 		Construct named @c VarType::integer with value.
@@ -177,10 +526,11 @@ public:
 		detail::var_config::name_type name,
 		detail::var_config::integer_type const value
 	)
-		: m_type(VarType::integer)
-		, m_name(std::move(name))
-		, m_integer(value)
-	{}
+		: m_name(std::move(name))
+		, m_type(VarType::integer)
+	{
+		m_integer = value;
+	}
 
 	/**
 		Construct nameless @c VarType::integer with value.
@@ -192,8 +542,9 @@ public:
 		detail::var_config::integer_type const value
 	)
 		: m_type(VarType::integer)
-		, m_integer(value)
-	{}
+	{
+		m_integer = value;
+	}
 
 	/**
 		Construct named @c VarType::decimal with value.
@@ -205,10 +556,11 @@ public:
 		detail::var_config::name_type name,
 		detail::var_config::decimal_type const value
 	)
-		: m_type(VarType::decimal)
-		, m_name(std::move(name))
-		, m_decimal(value)
-	{}
+		: m_name(std::move(name))
+		, m_type(VarType::decimal)
+	{
+		m_decimal = value;
+	}
 	/**
 		Construct nameless @c VarType::decimal with value.
 
@@ -219,8 +571,9 @@ public:
 		detail::var_config::decimal_type const value
 	)
 		: m_type(VarType::decimal)
-		, m_decimal(value)
-	{}
+	{
+		m_decimal = value;
+	}
 
 	/**
 		Construct named @c VarType::boolean with value.
@@ -232,10 +585,11 @@ public:
 		detail::var_config::name_type name,
 		detail::var_config::boolean_type const value
 	)
-		: m_type(VarType::boolean)
-		, m_name(std::move(name))
-		, m_boolean(value)
-	{}
+		: m_name(std::move(name))
+		, m_type(VarType::boolean)
+	{
+		m_boolean = value;
+	}
 
 	/**
 		Construct nameless @c VarType::boolean with value.
@@ -247,15 +601,64 @@ public:
 		detail::var_config::boolean_type const value
 	)
 		: m_type(VarType::boolean)
-		, m_boolean(value)
-	{}
+	{
+		m_boolean = value;
+	}
 
 	/** Copy constructor. */
-	Var(Var const&) = default;
-	/** Move constructor. */
-	Var(Var&&) = default;
+	Var(
+		Var const& other
+	)
+		: m_name(other.m_name)
+		, m_type(other.m_type)
+	{
+		switch (m_type) {
+		case VarType::string:
+			if (nullptr != other.m_strv) {
+				m_strv = make_box<detail::var_config::string_type>(*other.m_strv);
+			}
+			break;
+		case VarType::array:
+		case VarType::node:
+		case VarType::identifier:
+		#if (0 != DUCT_CONFIG_VAR_COPY_ON_WRITE)
+			m_collection = other.m_collection;
+			if (nullptr != m_collection) {
+				m_collection->refs.fetch_add(1u, std::memory_order_relaxed);
+			}
+		#else
+			if (nullptr != other.m_collection) {
+				m_collection = make_box<Collection>(
+					other.m_collection->children
+				);
+			}
+		#endif
+			break;
+		default:
+			m_bits = other.m_bits;
+			break;
+		}
+	}
+
+	/**
+		Move constructor.
+
+		@note @a other keeps its type, but its value is reset.
+	*/
+	Var(
+		Var&& other
+	) noexcept
+		: m_name(std::move(other.m_name))
+		, m_type(other.m_type)
+	{
+		m_bits = other.m_bits;
+		other.m_bits = 0u;
+	}
+
 	/** Destructor. */
-	~Var() = default;
+	~Var() {
+		release();
+	}
 /// @}
 
 /** @name Operators */ /// @{
@@ -272,39 +675,33 @@ public:
 	operator=(
 		Var const& other
 	) {
-		if (
-			other.m_type != m_type &&
-			!(
-				var_type_is_of(m_type, VarMask::collection) &&
-				var_type_is_of(other.m_type, VarMask::collection)
-			)
-		) {
-			reset();
+		if (this != &other) {
+			// other may be owned by this
+			Var copy{other};
+			*this = std::move(copy);
 		}
-		m_type = other.m_type;
-		m_name = other.m_name;
-		switch (other.m_type) {
-		case VarType::string: m_strv = other.m_strv; break;
-		case VarType::integer: m_integer = other.m_integer; break;
-		case VarType::decimal: m_decimal = other.m_decimal; break;
-		case VarType::boolean: m_boolean = other.m_boolean; break;
-
-		case VarType::array:
-		case VarType::node:
-		case VarType::identifier:
-			m_children.assign(
-				other.m_children.cbegin(),
-				other.m_children.cend()
-			);
-			break;
+		return *this;
+	}
 
-		case VarType::null:
-			break;
+	/** Move assignment operator. */
+	Var&
+	operator=(
+		Var&& other
+	) noexcept {
+		if (this != &other) {
+			// other may be owned by this
+			Var moved{std::move(other)};
+			release();
+			if (m_name != moved.m_name) {
+				m_name = std::move(moved.m_name);
+				bump_name_generation();
+			}
+			m_type = moved.m_type;
+			m_bits = moved.m_bits;
+			moved.m_bits = 0u;
 		}
 		return *this;
 	}
-	/** Move assignment operator. */
-	Var& operator=(Var&&) = default;
 /// @}
 
 /** @name Properties */ /// @{
@@ -329,10 +726,26 @@ public:
 	set_name(
 		detail::var_config::name_type name
 	) {
-		m_name.assign(std::move(name));
+		if (m_name != name) {
+			m_name = std::move(name);
+			bump_name_generation();
+		}
 		return *this;
 	}
 
+	/**
+		Get name generation.
+
+		@note This is a process-wide count that is incremented whenever
+		set_name() or assignment changes a Var's name. A Var cannot
+		tell its parent that it was renamed, so this is how lookups
+		(see find(u8string const&)) learn that an index may be stale.
+	*/
+	static std::uint64_t
+	name_generation() noexcept {
+		return name_generation_ref().load(std::memory_order_relaxed);
+	}
+
 	/**
 		Get name.
 
@@ -404,14 +817,22 @@ public:
 	Var&
 	reset() noexcept {
 		switch (m_type) {
-		case VarType::string: m_strv.clear(); break;
+		case VarType::string:
+			if (nullptr != m_strv) {
+				m_strv->clear();
+			}
+			break;
 		case VarType::integer: m_integer = 0; break;
 		case VarType::decimal: m_decimal = 0.0f; break;
 		case VarType::boolean: m_boolean = false; break;
 		case VarType::array:
 		case VarType::node:
 		case VarType::identifier:
-			m_children.clear();
+			detach_empty();
+			if (nullptr != m_collection) {
+				drop_index();
+				m_collection->children.clear();
+			}
 			break;
 		case VarType::null:
 		default:
@@ -436,12 +857,11 @@ public:
 	) noexcept {
 		if (type != m_type) {
 			if (
-				discard_children ||
-				!(
-					var_type_is_of(m_type, VarMask::collection) &&
-					var_type_is_of(type, VarMask::collection)
-				)
+				!var_type_is_of(m_type, VarMask::collection) ||
+				!var_type_is_of(type, VarMask::collection)
 			) {
+				release();
+			} else if (discard_children) {
 				reset();
 			}
 			m_type = type;
@@ -470,7 +890,7 @@ public:
 		DUCT_ASSERTE(var_type_is_of(type, VarMask::collection));
 		if (type != m_type) {
 			if (!var_type_is_of(m_type, VarMask::collection)) {
-				reset();
+				release();
 			}
 			m_type = type;
 		}
@@ -499,7 +919,7 @@ public:
 		static constexpr VarType const
 			type = detail::type_to_valtype<T>::value;
 		if (type != m_type) {
-			reset();
+			release();
 			m_type = type;
 		}
 		assign(value);
@@ -519,7 +939,7 @@ public:
 		detail::var_config::string_type value
 	) {
 		if (VarType::string != m_type) {
-			reset();
+			release();
 			m_type = VarType::string;
 		}
 		assign(std::move(value));
@@ -607,7 +1027,7 @@ public:
 	) const {
 		switch (m_type | other.m_type) {
 		case VarType::null: return 0;
-		case VarType::string: return m_strv.compare(other.m_strv);
+		case VarType::string: return string_ref().compare(other.string_ref());
 		case VarType::integer: return m_integer - other.m_integer;
 		case VarType::decimal:
 			return
@@ -622,12 +1042,14 @@ public:
 		case VarType::node:
 		case VarType::identifier: {
 			auto const sdiff = size() - other.size();
-			if (0 != sdiff || 0 == size()) { // If not equivalent or both 0
+			if (m_collection == other.m_collection) { // If shared
+				return 0;
+			} else if (0 != sdiff || 0 == size()) { // If not equivalent or both 0
 				return sdiff;
 			} else { // If equivalent and not 0
 				signed vdiff;
-				auto oi = other.m_children.cbegin();
-				for (auto const& tv : m_children) {
+				auto oi = other.m_collection->children.cbegin();
+				for (auto const& tv : m_collection->children) {
 					vdiff = tv.compare_value(*oi);
 					if (0 != vdiff) {
 						return vdiff;
@@ -684,7 +1106,11 @@ public:
 		detail::var_config::string_type value
 	) {
 		DUCT_ASSERTE(DUCT_V_TYPE_ == m_type);
-		DUCT_V_FIELD_.assign(std::move(value));
+		if (nullptr != m_strv) {
+			m_strv->assign(std::move(value));
+		} else if (!value.empty()) {
+			m_strv = make_box<detail::var_config::string_type>(std::move(value));
+		}
 		return *this;
 	}
 
@@ -694,19 +1120,24 @@ public:
 	*/
 	detail::var_config::string_type
 	string() const {
-		DUCT_V_get_value_();
+		return string_ref();
 	}
 
 	/** @copydoc string() */
 	detail::var_config::string_type&
-	string_ref() noexcept {
-		DUCT_V_get_value_();
+	string_ref() {
+		DUCT_ASSERTE(DUCT_V_TYPE_ == m_type);
+		if (nullptr == m_strv) {
+			m_strv = make_box<detail::var_config::string_type>();
+		}
+		return *m_strv;
 	}
 
 	/** @copydoc string() */
 	detail::var_config::string_type const&
 	string_ref() const noexcept {
-		DUCT_V_get_value_();
+		DUCT_ASSERTE(DUCT_V_TYPE_ == m_type);
+		return (nullptr != m_strv) ? *m_strv : empty_string();
 	}
 
 	/** @cond */
@@ -858,7 +1289,7 @@ public:
 		DUCT_ASSERTE(enum_cast(m_type) & enum_cast(VarMask::value_nullable));
 		switch (m_type) {
 		case VarType::null: out_str = "null"; break;
-		case VarType::string: StringUtils::convert(out_str, m_strv); break;
+		case VarType::string: StringUtils::convert(out_str, string_ref()); break;
 		case VarType::boolean: out_str = (m_boolean) ? "true" : "false"; break;
 		default: {
 			aux::stringstream stream;
@@ -885,9 +1316,9 @@ public:
 		Get beginning child iterator.
 	*/
 	iterator
-	begin() noexcept {
+	begin() {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.begin();
+		return children_view().begin();
 	}
 
 	/**
@@ -896,23 +1327,23 @@ public:
 	const_iterator
 	begin() const noexcept {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.cbegin();
+		return children_view().cbegin();
 	}
 
 	/** @copydoc begin() */
 	const_iterator
 	cbegin() const noexcept {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.cbegin();
+		return children_view().cbegin();
 	}
 
 	/**
 		Get ending child iterator.
 	*/
 	iterator
-	end() noexcept {
+	end() {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.end();
+		return children_view().end();
 	}
 
 	/**
@@ -921,14 +1352,14 @@ public:
 	const_iterator
 	end() const noexcept {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.cend();
+		return children_view().cend();
 	}
 
 	/** @copydoc end() */
 	const_iterator
 	cend() const noexcept {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.cend();
+		return children_view().cend();
 	}
 
 	/**
@@ -939,7 +1370,7 @@ public:
 	bool
 	empty() const noexcept {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.empty();
+		return children_view().empty();
 	}
 
 	/**
@@ -950,7 +1381,7 @@ public:
 	vector_type::size_type
 	size() const noexcept {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.size();
+		return children_view().size();
 	}
 
 	/**
@@ -963,25 +1394,38 @@ public:
 		vector_type new_children
 	) {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		m_children = std::move(new_children);
+		detach_empty();
+		if (nullptr != m_collection) {
+			drop_index();
+			m_collection->children = std::move(new_children);
+		} else if (!new_children.empty()) {
+			m_collection = make_box<Collection>(std::move(new_children));
+		}
 	}
 
 	/**
 		Get children.
 
+		@note Lookups (see find(u8string const&)) scan the collection
+		until it is next changed by push_back(), emplace_back(),
+		erase(), set_children() or reset().
+
 		@returns The current child collection.
 	*/
 	vector_type&
-	children() noexcept {
+	children() {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children;
+		vector_type& children = children_box();
+		drop_index();
+		m_collection->exposed = true;
+		return children;
 	}
 
 	/** @copydoc children() */
 	vector_type const&
 	children() const noexcept {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children;
+		return children_view();
 	}
 
 	/**
@@ -990,7 +1434,7 @@ public:
 	Var&
 	front() {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.front();
+		return children_view().front();
 	}
 
 	/**
@@ -999,7 +1443,7 @@ public:
 	Var const&
 	front() const {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.front();
+		return children_view().front();
 	}
 
 	/**
@@ -1008,7 +1452,7 @@ public:
 	Var&
 	back() {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.back();
+		return children_view().back();
 	}
 
 	/**
@@ -1017,7 +1461,7 @@ public:
 	Var const&
 	back() const {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.back();
+		return children_view().back();
 	}
 
 	/**
@@ -1030,7 +1474,7 @@ public:
 		std::size_t const index
 	) {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.at(index);
+		return children_view().at(index);
 	}
 
 	/**
@@ -1043,7 +1487,7 @@ public:
 		std::size_t const index
 	) const {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		return m_children.at(index);
+		return children_view().at(index);
 	}
 
 	/**
@@ -1056,7 +1500,10 @@ public:
 		iterator const pos
 	) {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		m_children.erase(pos);
+		auto const offset = pos - children_view_const().cbegin();
+		detach();
+		drop_index();
+		m_collection->children.erase(m_collection->children.cbegin() + offset);
 	}
 
 	/**
@@ -1069,7 +1516,10 @@ public:
 		const_iterator const pos
 	) {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		m_children.erase(pos);
+		auto const offset = pos - children_view_const().cbegin();
+		detach();
+		drop_index();
+		m_collection->children.erase(m_collection->children.cbegin() + offset);
 	}
 
 	/**
@@ -1083,7 +1533,8 @@ public:
 		Var var
 	) {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		m_children.push_back(std::move(var));
+		children_box().push_back(std::move(var));
+		index_append(*m_collection);
 		return *this;
 	}
 
@@ -1099,12 +1550,291 @@ public:
 	Var&
 	emplace_back(ArgP&&... args) {
 		DUCT_ASSERTE(is_type_of(VarMask::collection));
-		m_children.emplace_back(std::forward<ArgP>(args)...);
+		children_box().emplace_back(std::forward<ArgP>(args)...);
+		index_append(*m_collection);
 		return *this;
 	}
+
+	/**
+		Find the first child with a name.
+
+		@note Collections with at least
+		#DUCT_CONFIG_VAR_INDEX_THRESHOLD children are searched through
+		a hash index of their children's names. The index is built by
+		the first lookup and kept through push_back() and
+		emplace_back(). It is dropped by erase(), set_children() and
+		reset(). Non-const children() drops it and disables it until
+		the collection is next changed by one of those functions, so
+		lookups scan the collection meanwhile. After any Var is renamed (see
+		name_generation()), the next lookup checks the index against
+		the children's names, and rebuilds it only if one of them
+		changed.
+
+		@note Const lookups on the same collection can be made from
+		multiple threads. A lookup rebuilds a stale index in place
+		only while no other lookup is reading it; until then, lookups
+		scan the collection.
+
+		@returns The first child named @a name, or @c nullptr if there
+		is none.
+		@param name Name to find.
+	*/
+	Var*
+	find(
+		u8string const& name
+	) {
+		detach();
+		return const_cast<Var*>(static_cast<Var const*>(this)->find(name));
+	}
+
+	/** @copydoc find(u8string const&) */
+	Var const*
+	find(
+		u8string const& name
+	) const {
+		DUCT_ASSERTE(is_type_of(VarMask::collection));
+		Var const* found = nullptr;
+		find_each(
+			name.data(), name.size(), hash_name(name.data(), name.size()),
+			[this, &found](std::size_t const i) {
+				found = &m_collection->children[i];
+				return false;
+			}
+		);
+		return found;
+	}
+
+	/**
+		Find all children with a name.
+
+		@note See find(u8string const&) for how lookups are indexed.
+
+		@returns The children named @a name, in order.
+		@param name Name to find.
+	*/
+	aux::vector<Var*>
+	find_all(
+		u8string const& name
+	) {
+		detach();
+		aux::vector<Var*> found;
+		find_each(
+			name.data(), name.size(), hash_name(name.data(), name.size()),
+			[this, &found](std::size_t const i) {
+				found.push_back(&m_collection->children[i]);
+				return true;
+			}
+		);
+		return found;
+	}
+
+	/** @copydoc find_all(u8string const&) */
+	aux::vector<Var const*>
+	find_all(
+		u8string const& name
+	) const {
+		aux::vector<Var const*> found;
+		find_each(
+			name.data(), name.size(), hash_name(name.data(), name.size()),
+			[this, &found](std::size_t const i) {
+				found.push_back(&m_collection->children[i]);
+				return true;
+			}
+		);
+		return found;
+	}
 /** @} */
 };
 
 /** @} */ // end doc-group var
 
+inline void
+Var::index_fill(
+	Index& index,
+	vector_type const& children,
+	std::uint64_t const generation
+) {
+	DUCT_ASSERTE(0xFFFFFFFFu > children.size());
+	// Keep the load at or below half
+	std::size_t capacity = 16u;
+	while (capacity < children.size() * 2u) {
+		capacity <<= 1u;
+	}
+	index.slots.assign(capacity, IndexSlot{0u, 0u});
+	index.count = 0u;
+	index.generation.store(generation, std::memory_order_relaxed);
+	for (std::size_t i = 0u; children.size() > i; ++i) {
+		auto const& name = children[i].m_name;
+		index_insert(index, hash_name(name.data(), name.size()), i);
+	}
+}
+
+inline bool
+Var::index_verify(
+	Index const& index,
+	vector_type const& children
+) noexcept {
+	// Each child has exactly one slot
+	for (auto const& slot : index.slots) {
+		if (0u != slot.position) {
+			auto const& name = children[slot.position - 1u].m_name;
+			if (slot.hash != hash_name(name.data(), name.size())) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+inline void
+Var::index_rebuild(
+	Collection& collection
+) {
+	// The collection is being changed, so no lookup is running
+	if (nullptr == collection.index) {
+		collection.index = make_box<Index>();
+	}
+	collection.lookups.store(0u, std::memory_order_relaxed);
+	index_fill(*collection.index, collection.children, name_generation());
+}
+
+inline void
+Var::index_append(
+	Collection& collection
+) {
+	collection.exposed = false;
+	Index* const index = collection.index;
+	if (nullptr != index) {
+		std::size_t const position = collection.children.size() - 1u;
+		if (
+			index->count != position ||
+			index->slots.size() < collection.children.size() * 2u
+		) {
+			index_rebuild(collection);
+		} else {
+			auto const& name = collection.children[position].m_name;
+			index_insert(*index, hash_name(name.data(), name.size()), position);
+		}
+	}
+}
+
+inline Var::Index const*
+Var::index_rebuild_shared(
+	Collection& collection,
+	std::uint64_t const generation
+) {
+	// Called with lookup_rebuilding set, so no other lookup is
+	// reading the index
+	try {
+		if (nullptr == collection.index) {
+			collection.index = make_box<Index>();
+		}
+		index_fill(*collection.index, collection.children, generation);
+	} catch (...) {
+		free_box(collection.index);
+		collection.index = nullptr;
+		collection.lookups.store(0u, std::memory_order_release);
+		throw;
+	}
+	// Stay entered as a lookup
+	collection.lookups.store(1u, std::memory_order_release);
+	return collection.index;
+}
+
+inline Var::Index const*
+Var::index_acquire(
+	Collection& collection
+) {
+	// Read before the names are, so that a rename after this is seen
+	// by the next lookup
+	std::uint64_t const generation = name_generation();
+	auto& lookups = collection.lookups;
+	std::uint32_t state = lookups.load(std::memory_order_relaxed);
+	for (;;) {
+		if (0u != (state & lookup_rebuilding)) {
+			return nullptr;
+		} else if (0u != (state & lookup_stale)) {
+			if (lookup_stale != state) {
+				return nullptr;
+			} else if (lookups.compare_exchange_weak(
+				state, lookup_rebuilding,
+				std::memory_order_acquire, std::memory_order_relaxed
+			)) {
+				return index_rebuild_shared(collection, generation);
+			}
+		} else if (lookups.compare_exchange_weak(
+			state, state + 1u,
+			std::memory_order_acquire, std::memory_order_relaxed
+		)) {
+			break;
+		}
+	}
+	Index* const index = collection.index;
+	if (nullptr != index && index->count == collection.children.size()) {
+		if (generation == index->generation.load(std::memory_order_relaxed)) {
+			return index;
+		} else if (index_verify(*index, collection.children)) {
+			index->generation.store(generation, std::memory_order_relaxed);
+			return index;
+		}
+	}
+	state = 1u;
+	if (lookups.compare_exchange_strong(
+		state, lookup_rebuilding,
+		std::memory_order_acquire, std::memory_order_relaxed
+	)) {
+		return index_rebuild_shared(collection, generation);
+	}
+	// Other lookups are reading the index
+	lookups.fetch_or(lookup_stale, std::memory_order_relaxed);
+	lookups.fetch_sub(1u, std::memory_order_release);
+	return nullptr;
+}
+
+template<class F>
+inline void
+Var::find_each(
+	char const* const data,
+	std::size_t const size,
+	std::uint32_t const hash,
+	F&& f
+) const {
+	DUCT_ASSERTE(is_type_of(VarMask::collection));
+	if (nullptr == m_collection) {
+		return;
+	}
+	auto const& children = m_collection->children;
+	Index const* const index
+		= (
+			DUCT_CONFIG_VAR_INDEX_THRESHOLD > children.size() ||
+			m_collection->exposed
+		)
+		? nullptr
+		: index_acquire(*m_collection)
+	;
+	if (nullptr == index) {
+		for (std::size_t i = 0u; children.size() > i; ++i) {
+			if (name_equals(children[i], data, size) && !f(i)) {
+				return;
+			}
+		}
+		return;
+	}
+	IndexLease const lease{*m_collection};
+	auto const& slots = index->slots;
+	std::size_t const mask = slots.size() - 1u;
+	for (std::size_t i = hash & mask;; i = (i + 1u) & mask) {
+		IndexSlot const slot = slots[i];
+		if (0u == slot.position) {
+			return;
+		} else if (
+			hash == slot.hash &&
+			name_equals(children[slot.position - 1u], data, size) &&
+			!f(slot.position - 1u)
+		) {
+			return;
+		}
+	}
+}
+
 } // namespace duct
@@ -0,0 +1,483 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief VarPath class.
+*/
+
+#pragma once
+
+#include "./config.hpp"
+#include "./aux.hpp"
+#include "./string.hpp"
+#include "./debug.hpp"
+#include "./VarType.hpp"
+#include "./Var.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace duct {
+
+// Forward declarations
+class VarPath;
+
+/**
+	@addtogroup var
+	@{
+*/
+
+/**
+	Compiled path to a descendant of a Var.
+
+	A path is a sequence of components: names separated by @c '.',
+	and child indices in brackets. For example,
+	@c "render.shadows.cascades[2]" is the third child of the first
+	child named @c "cascades" of the first child named @c "shadows"
+	of the first child named @c "render". An empty path is the root
+	itself.
+
+	@note Names are hashed when the path is parsed, so lookups
+	through indexed collections (see Var::find()) do not hash them
+	again.
+*/
+class VarPath final {
+public:
+/** @name Types */ /// @{
+	/** Path component. */
+	struct Component final {
+		/** Name; empty for an index component. */
+		u8string name;
+		/** Hash of name. */
+		std::uint32_t hash;
+		/** Child index; only for an index component. */
+		std::size_t index;
+		/** Whether this is an index component. */
+		bool is_index;
+	};
+
+	/**
+		Resolution cache.
+
+		@note A cache records the children a path resolved to under a
+		root. The next resolution through the same cache follows the
+		recorded positions if the root, the name generation (see
+		Var::name_generation()), and the address and size of each
+		collection on the path are unchanged, and each named child on
+		the path still has its name.
+
+		@note A cache is only valid for the path it was used with.
+		Separate threads must use separate caches.
+	*/
+	class Cache final {
+		friend class VarPath;
+
+	private:
+		struct Level final {
+			Var const* data;
+			std::size_t size;
+			std::size_t position;
+		};
+
+		Var const* m_root{nullptr};
+		std::uint64_t m_generation{0u};
+		aux::vector<Level> m_levels{};
+
+	public:
+		/** Default constructor. */
+		Cache() = default;
+		/** Copy constructor. */
+		Cache(Cache const&) = default;
+		/** Move constructor. */
+		Cache(Cache&&) = default;
+		/** Destructor. */
+		~Cache() = default;
+
+		/** Copy assignment operator. */
+		Cache& operator=(Cache const&) = default;
+		/** Move assignment operator. */
+		Cache& operator=(Cache&&) = default;
+
+		/**
+			Clear the cache.
+		*/
+		void
+		clear() noexcept {
+			m_root = nullptr;
+			m_levels.clear();
+		}
+	};
+/// @}
+
+private:
+	aux::vector<Component> m_components{};
+	bool m_valid{true};
+
+public:
+/** @name Constructors and destructor */ /// @{
+	/** Construct empty. */
+	VarPath() = default;
+
+	/**
+		Construct with path.
+
+		@param path Path.
+		@sa assign(char const*, std::size_t)
+	*/
+	explicit
+	VarPath(
+		u8string const& path
+	) {
+		assign(path.data(), path.size());
+	}
+
+	/**
+		Construct with path.
+
+		@param path Path (C-string).
+		@sa assign(char const*, std::size_t)
+	*/
+	explicit
+	VarPath(
+		char const* const path
+	) {
+		assign(path, std::strlen(path));
+	}
+
+	/** Copy constructor. */
+	VarPath(VarPath const&) = default;
+	/** Move constructor. */
+	VarPath(VarPath&&) = default;
+	/** Destructor. */
+	~VarPath() = default;
+/// @}
+
+/** @name Operators */ /// @{
+	/** Copy assignment operator. */
+	VarPath& operator=(VarPath const&) = default;
+	/** Move assignment operator. */
+	VarPath& operator=(VarPath&&) = default;
+/// @}
+
+/** @name Properties */ /// @{
+	/**
+		Check if the path is valid.
+
+		@returns @c false if the last assignment failed to parse.
+	*/
+	bool
+	valid() const noexcept {
+		return m_valid;
+	}
+
+	/**
+		Get components.
+	*/
+	aux::vector<Component> const&
+	components() const noexcept {
+		return m_components;
+	}
+/// @}
+
+/** @name Operations */ /// @{
+	/**
+		Parse a path.
+
+		@note On failure, the path is cleared and invalid; an invalid
+		path does not resolve.
+
+		@returns @c true if the path was parsed.
+		@param data Path data.
+		@param size Size of @a data in bytes.
+	*/
+	bool
+	assign(
+		char const* const data,
+		std::size_t const size
+	);
+
+	/** @copydoc assign(char const*, std::size_t) */
+	bool
+	assign(
+		u8string const& path
+	) {
+		return assign(path.data(), path.size());
+	}
+
+	/**
+		Resolve the path.
+
+		@note Each name component selects the first child with the
+		name (as Var::find()).
+
+		@returns The variable at the path, or @c nullptr if there is
+		none or the path is invalid.
+		@param root Root variable.
+	*/
+	Var const*
+	resolve(
+		Var const& root
+	) const;
+
+	/**
+		Resolve the path for modification.
+
+		@note With #DUCT_CONFIG_VAR_COPY_ON_WRITE, each collection on
+		the path is detached from its copies, as by Var::at().
+
+		@returns The variable at the path, or @c nullptr if there is
+		none or the path is invalid.
+		@param root Root variable.
+	*/
+	Var*
+	resolve(
+		Var& root
+	) const;
+
+	/**
+		Resolve the path through a cache.
+
+		@returns The variable at the path, or @c nullptr if there is
+		none or the path is invalid.
+		@param root Root variable.
+		@param cache Resolution cache.
+		@sa Cache
+	*/
+	Var const*
+	resolve(
+		Var const& root,
+		Cache& cache
+	) const;
+
+	/**
+		Resolve the path for modification through a cache.
+
+		@note With #DUCT_CONFIG_VAR_COPY_ON_WRITE, each collection on
+		the path is detached from its copies, as by Var::at().
+
+		@returns The variable at the path, or @c nullptr if there is
+		none or the path is invalid.
+		@param root Root variable.
+		@param cache Resolution cache.
+		@sa Cache
+	*/
+	Var*
+	resolve(
+		Var& root,
+		Cache& cache
+	) const;
+/// @}
+
+private:
+	// Child position for a component, or ~0 if there is none
+	static std::size_t
+	step(
+		Var const& var,
+		Component const& component
+	);
+};
+
+/** @} */ // end of doc-group var
+
+inline bool
+VarPath::assign(
+	char const* const data,
+	std::size_t const size
+) {
+	m_components.clear();
+	m_valid = true;
+	char const* pos = data;
+	char const* const end = data + size;
+	bool expect_name = (end != pos && '[' != *pos);
+	while (end != pos) {
+		if (expect_name) {
+			char const* name_end = pos;
+			while (end != name_end && '.' != *name_end && '[' != *name_end) {
+				++name_end;
+			}
+			if (name_end == pos) {
+				break;
+			}
+			std::size_t const name_size = static_cast<std::size_t>(name_end - pos);
+			m_components.push_back(Component{
+				u8string(pos, name_size),
+				Var::hash_name(pos, name_size),
+				0u, false
+			});
+			pos = name_end;
+		} else {
+			// '[' digit+ ']'
+			char const* const digits = ++pos;
+			std::size_t index = 0u;
+			for (; end != pos && '0' <= *pos && '9' >= *pos; ++pos) {
+				std::size_t const next
+					= index * 10u
+					+ static_cast<std::size_t>(*pos - '0')
+				;
+				if (next / 10u != index) {
+					break;
+				}
+				index = next;
+			}
+			if (digits == pos || end == pos || ']' != *pos) {
+				break;
+			}
+			++pos;
+			m_components.push_back(Component{u8string{}, 0u, index, true});
+		}
+		if (end == pos) {
+			return true;
+		} else if ('.' == *pos && end != pos + 1) {
+			++pos;
+			expect_name = true;
+		} else if ('[' == *pos) {
+			expect_name = false;
+		} else {
+			break;
+		}
+	}
+	// Only an empty path leaves the loop without a failure
+	if (0u != size) {
+		m_components.clear();
+		m_valid = false;
+	}
+	return m_valid;
+}
+
+inline std::size_t
+VarPath::step(
+	Var const& var,
+	Component const& component
+) {
+	if (!var.is_type_of(VarMask::collection)) {
+		return ~std::size_t{0u};
+	} else if (component.is_index) {
+		return (var.size() > component.index) ? component.index : ~std::size_t{0u};
+	}
+	std::size_t position = ~std::size_t{0u};
+	var.find_each(
+		component.name.data(), component.name.size(), component.hash,
+		[&position](std::size_t const i) {
+			position = i;
+			return false;
+		}
+	);
+	return position;
+}
+
+inline Var const*
+VarPath::resolve(
+	Var const& root
+) const {
+	if (!m_valid) {
+		return nullptr;
+	}
+	Var const* var = &root;
+	for (auto const& component : m_components) {
+		std::size_t const position = step(*var, component);
+		if (~std::size_t{0u} == position) {
+			return nullptr;
+		}
+		var = var->children().data() + position;
+	}
+	return var;
+}
+
+inline Var*
+VarPath::resolve(
+	Var& root
+) const {
+	if (!m_valid) {
+		return nullptr;
+	}
+	Var* var = &root;
+	for (auto const& component : m_components) {
+		std::size_t const position = step(*var, component);
+		if (~std::size_t{0u} == position) {
+			return nullptr;
+		}
+		// Detaches a shared collection
+		var = var->children_view().data() + position;
+	}
+	return var;
+}
+
+inline Var const*
+VarPath::resolve(
+	Var const& root,
+	Cache& cache
+) const {
+	if (!m_valid) {
+		return nullptr;
+	}
+	std::uint64_t const generation = Var::name_generation();
+	Var const* var = &root;
+	if (
+		&root == cache.m_root &&
+		generation == cache.m_generation &&
+		m_components.size() == cache.m_levels.size()
+	) {
+		std::size_t i = 0u;
+		for (; m_components.size() > i; ++i) {
+			auto const& level = cache.m_levels[i];
+			auto const& component = m_components[i];
+			if (
+				!var->is_type_of(VarMask::collection) ||
+				var->size() != level.size ||
+				var->children().data() != level.data
+			) {
+				break;
+			}
+			Var const& child = level.data[level.position];
+			if (
+				!component.is_index &&
+				!Var::name_equals(child, component.name.data(), component.name.size())
+			) {
+				break;
+			}
+			var = &child;
+		}
+		if (m_components.size() == i) {
+			return var;
+		}
+		var = &root;
+	}
+
+	cache.clear();
+	for (auto const& component : m_components) {
+		std::size_t const position = step(*var, component);
+		if (~std::size_t{0u} == position) {
+			cache.clear();
+			return nullptr;
+		}
+		Var const* const data = var->children().data();
+		cache.m_levels.push_back({data, var->size(), position});
+		var = data + position;
+	}
+	cache.m_root = &root;
+	cache.m_generation = generation;
+	return var;
+}
+
+inline Var*
+VarPath::resolve(
+	Var& root,
+	Cache& cache
+) const {
+	if (nullptr == resolve(static_cast<Var const&>(root), cache)) {
+		return nullptr;
+	}
+	// Detach each collection on the path; detached collections have
+	// new addresses, which the cache takes
+	Var* var = &root;
+	for (auto& level : cache.m_levels) {
+		Var* const data = var->children_view().data();
+		level.data = data;
+		var = data + level.position;
+	}
+	return var;
+}
+
+} // namespace duct
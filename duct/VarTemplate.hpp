@@ -127,7 +127,8 @@ public:
 	};
 
 	/** Identity vector type. */
-	using identity_vector_type = duct::aux::vector<u8string>;
+	using identity_vector_type
+		= duct::aux::vector<detail::var_config::name_type>;
 	/** Layout vector type. */
 	using layout_vector_type = duct::aux::vector<Field>;
 /// @}
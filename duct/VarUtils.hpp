@@ -8,13 +8,22 @@
 #pragma once
 
 #include "./config.hpp"
+#include "./aux.hpp"
 #include "./string.hpp"
 #include "./detail/string_traits.hpp"
 #include "./detail/var.hpp"
+#include "./detail/hash.hpp"
+#include "./detail/arithmetic.hpp"
 #include "./StateStore.hpp"
 #include "./CharacterRange.hpp"
 #include "./Var.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
 namespace duct {
 namespace VarUtils {
 
@@ -71,7 +80,9 @@ parse_lit(
 	- @c "true" morphs to a @c VarType::boolean with @c true.
 	- @c "null" morphs to a @c VarType::null.
 	- @c [+\-]?[0-9.]* morphs to a @c VarType::integer
-	  or @c VarType::decimal.
+	  or @c VarType::decimal. Values which overflow the numeric type
+	  morph to @c 0 (or @c 0.0f). Numbers are parsed without the
+	  current locale.
 	- Else morphs to a @c VarType::string with @c value.
 
 	@param var Var to modify.
@@ -152,17 +163,18 @@ convert_typed(
 		// Consists of only signs or only a decimal
 		goto l_string;
 	} else {
-		aux::istringstream stream(value);
 		if (has_decimal) {
 			var.morph(0.0f);
-			stream >> var.decimal_ref();
-			if (stream.fail()) {
+			if (!detail::parse_arithmetic(
+				value.cbegin(), value.cend(), var.decimal_ref()
+			)) {
 				var.assign(0.0f);
 			}
 		} else {
 			var.morph(0);
-			stream >> var.integer_ref();
-			if (stream.fail()) {
+			if (!detail::parse_arithmetic(
+				value.cbegin(), value.cend(), var.integer_ref()
+			)) {
 				var.assign(0);
 			}
 		}
@@ -211,6 +223,391 @@ convert_typed(
 	return var;
 }
 
+/**
+	@name Diff and patch
+	@{
+*/
+
+/**
+	Patch operation kinds.
+*/
+enum class PatchKind : unsigned {
+	/** Insert PatchOp::value before the child at the path. */
+	insert,
+	/** Remove the child at the path. */
+	remove,
+	/** Replace the variable at the path with PatchOp::value. */
+	replace
+};
+
+/**
+	Patch operation.
+*/
+struct PatchOp final {
+	/** Kind. */
+	PatchKind kind;
+	/**
+		Child indices from the root to the target.
+
+		@note Indices refer to the tree as modified by the preceding
+		operations. An empty path refers to the root.
+	*/
+	aux::vector<std::size_t> path;
+	/** Value to insert or replace with. */
+	Var value;
+};
+
+/**
+	Patch.
+*/
+using Patch = aux::vector<PatchOp>;
+
+/** @cond INTERNAL */
+namespace {
+
+struct DiffEntry final {
+	std::uint64_t hash;
+	// Variables in the subtree, including the root
+	std::size_t count;
+};
+
+struct DiffState final {
+	aux::vector<DiffEntry> from_tree;
+	aux::vector<DiffEntry> to_tree;
+	aux::vector<std::size_t> path;
+};
+
+// Multiply-fold over 8-byte words, then FNV-1a over the tail
+inline std::uint64_t
+hash_bytes(
+	std::uint64_t hash,
+	void const* const data,
+	std::size_t size
+) noexcept {
+	auto const* bytes = static_cast<unsigned char const*>(data);
+	for (; 8u <= size; bytes += 8u, size -= 8u) {
+		std::uint64_t word;
+		std::memcpy(&word, bytes, 8u);
+		hash = (hash ^ word) * 0x9E3779B97F4A7C15u;
+		hash ^= hash >> 32u;
+	}
+	return detail::fnv1a(bytes, size, hash);
+}
+
+template<class T>
+inline std::uint64_t
+hash_value(
+	std::uint64_t const hash,
+	T const value
+) noexcept {
+	return hash_bytes(hash, &value, sizeof(T));
+}
+
+// Hashes every variable in the tree in pre-order
+inline std::size_t
+hash_tree(
+	Var const& var,
+	aux::vector<DiffEntry>& tree
+) {
+	std::size_t const index = tree.size();
+	tree.push_back(DiffEntry{0u, 1u});
+	u8string const& name = var.name();
+	std::uint64_t hash = detail::fnv1a_params<std::uint64_t>::basis;
+	hash = hash_value(hash, static_cast<unsigned>(var.type()));
+	hash = hash_value(hash, name.size());
+	hash = hash_bytes(hash, name.data(), name.size());
+	switch (var.type()) {
+	case VarType::string:
+		hash = hash_bytes(hash, var.string_ref().data(), var.string_ref().size());
+		break;
+	case VarType::integer: hash = hash_value(hash, var.integer()); break;
+	case VarType::decimal: hash = hash_value(hash, var.decimal()); break;
+	case VarType::boolean: hash = hash_value(hash, var.boolean()); break;
+
+	case VarType::array:
+	case VarType::node:
+	case VarType::identifier:
+		hash = hash_value(hash, var.size());
+		for (auto const& child : var) {
+			hash = hash_value(hash, tree[hash_tree(child, tree)].hash);
+		}
+		break;
+
+	default:
+		break;
+	}
+	// Finalize, so that similar variables have dissimilar hashes
+	hash = (hash ^ (hash >> 33u)) * 0xFF51AFD7ED558CCDu;
+	hash = (hash ^ (hash >> 33u)) * 0xC4CEB9FE1A85EC53u;
+	hash ^= hash >> 33u;
+	tree[index] = DiffEntry{hash, tree.size() - index};
+	return index;
+}
+
+// Pre-order indices of the children of the variable at index
+inline void
+child_indices(
+	Var const& var,
+	aux::vector<DiffEntry> const& tree,
+	std::size_t index,
+	aux::vector<std::size_t>& indices
+) {
+	indices.clear();
+	indices.reserve(var.size());
+	for (++index; indices.size() < var.size(); index += tree[index].count) {
+		indices.push_back(index);
+	}
+}
+
+} // anonymous namespace
+/** @endcond */ // INTERNAL
+
+/**
+	Check if two variables are identical.
+
+	@note Unlike Var::equals(), this also compares the names of
+	children. Decimals are compared by bit pattern, so @c 0.0 and
+	@c -0.0 are not identical, and a NaN is identical to itself.
+
+	@returns @c true if @a x and @a y have the same type, name and
+	value, and identical children.
+	@param x First variable.
+	@param y Second variable.
+*/
+inline bool
+identical(
+	Var const& x,
+	Var const& y
+) {
+	if (x.type() != y.type() || 0 != x.name().compare(y.name())) {
+		return false;
+	}
+	switch (x.type()) {
+	case VarType::null: return true;
+	case VarType::string: return x.string_ref() == y.string_ref();
+	case VarType::integer: return x.integer() == y.integer();
+	case VarType::decimal: {
+		auto const xd = x.decimal();
+		auto const yd = y.decimal();
+		return 0 == std::memcmp(&xd, &yd, sizeof(xd));
+	}
+	case VarType::boolean: return x.boolean() == y.boolean();
+
+	case VarType::array:
+	case VarType::node:
+	case VarType::identifier: {
+		if (x.size() != y.size()) {
+			return false;
+		}
+		auto yi = y.cbegin();
+		for (auto const& child : x) {
+			if (!identical(child, *yi++)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	}
+	return false;
+}
+
+/**
+	Hash a variable.
+
+	@note Identical variables (see identical()) have equal hashes.
+
+	@returns Hash of the type, name, value and children of @a var.
+	@param var Variable to hash.
+*/
+inline std::uint64_t
+hash(
+	Var const& var
+) {
+	aux::vector<DiffEntry> tree{};
+	hash_tree(var, tree);
+	return tree.front().hash;
+}
+
+/** @cond INTERNAL */
+namespace {
+
+inline void
+diff_at(
+	Var const& from,
+	std::size_t const from_index,
+	Var const& to,
+	std::size_t const to_index,
+	DiffState& state,
+	Patch& patch
+) {
+	auto const same = [&state](
+		std::size_t const x,
+		std::size_t const y
+	) {
+		return state.from_tree[x].hash == state.to_tree[y].hash;
+	};
+	if (same(from_index, to_index)) {
+		return;
+	} else if (
+		from.type() != to.type() ||
+		0 != from.name().compare(to.name()) ||
+		!from.is_type_of(VarMask::collection)
+	) {
+		patch.push_back(PatchOp{PatchKind::replace, state.path, to});
+		return;
+	}
+
+	aux::vector<std::size_t> from_children{};
+	aux::vector<std::size_t> to_children{};
+	child_indices(from, state.from_tree, from_index, from_children);
+	child_indices(to, state.to_tree, to_index, to_children);
+	std::size_t const from_size = from.size();
+	std::size_t const to_size = to.size();
+	std::size_t const limit = std::min(from_size, to_size);
+
+	// Unchanged children at either end
+	std::size_t prefix = 0u;
+	while (limit > prefix && same(from_children[prefix], to_children[prefix])) {
+		++prefix;
+	}
+	std::size_t suffix = 0u;
+	while (limit - prefix > suffix && same(
+		from_children[from_size - suffix - 1u],
+		to_children[to_size - suffix - 1u]
+	)) {
+		++suffix;
+	}
+
+	// Changed children in between are paired up, and the remainder
+	// removed or inserted
+	std::size_t const from_end = from_size - suffix;
+	std::size_t const to_end = to_size - suffix;
+	std::size_t index = prefix;
+	for (; from_end > index && to_end > index; ++index) {
+		state.path.push_back(index);
+		diff_at(
+			from.at(index), from_children[index],
+			to.at(index), to_children[index],
+			state, patch
+		);
+		state.path.pop_back();
+	}
+	for (std::size_t count = from_end - index; 0u < count; --count) {
+		state.path.push_back(index);
+		patch.push_back(PatchOp{PatchKind::remove, state.path, Var{}});
+		state.path.pop_back();
+	}
+	for (; to_end > index; ++index) {
+		state.path.push_back(index);
+		patch.push_back(PatchOp{PatchKind::insert, state.path, to.at(index)});
+		state.path.pop_back();
+	}
+}
+
+} // anonymous namespace
+/** @endcond */ // INTERNAL
+
+/**
+	Calculate the difference between two variables.
+
+	@note Every variable in both trees is hashed once. Subtrees with
+	equal hashes are taken to be identical and skipped without being
+	compared, as are unchanged children at either end of a changed
+	collection. The changed children in between are compared in
+	pairs; any extra children are removed or inserted.
+	@warning A hash collision (which is improbable with 64-bit hashes)
+	would leave a change out of the patch.
+
+	@param from Original variable.
+	@param to Changed variable.
+	@param[out] patch Patch that changes @a from to @a to when
+	applied (see apply()). Existing operations are not removed.
+*/
+inline void
+diff(
+	Var const& from,
+	Var const& to,
+	Patch& patch
+) {
+	DiffState state{};
+	hash_tree(from, state.from_tree);
+	hash_tree(to, state.to_tree);
+	diff_at(from, 0u, to, 0u, state, patch);
+}
+
+/**
+	Calculate the difference between two variables.
+
+	@returns Patch that changes @a from to @a to.
+	@param from Original variable.
+	@param to Changed variable.
+	@sa diff(Var const&, Var const&, Patch&)
+*/
+inline Patch
+diff(
+	Var const& from,
+	Var const& to
+) {
+	Patch patch{};
+	diff(from, to, patch);
+	return patch;
+}
+
+/**
+	Apply a patch.
+
+	@note Operations are applied in order. If an operation's path is
+	not valid, the patch is only partially applied.
+
+	@returns @c true if every operation was applied; @c false if an
+	operation's path is not valid.
+	@param var Variable to patch.
+	@param patch Patch to apply.
+*/
+inline bool
+apply(
+	Var& var,
+	Patch const& patch
+) {
+	for (auto const& op : patch) {
+		if (op.path.empty()) {
+			if (PatchKind::replace != op.kind) {
+				return false;
+			}
+			var = op.value;
+			continue;
+		}
+		Var* parent = &var;
+		for (std::size_t i = 0u; op.path.size() - 1u > i; ++i) {
+			if (
+				!parent->is_type_of(VarMask::collection) ||
+				parent->size() <= op.path[i]
+			) {
+				return false;
+			}
+			parent = &parent->at(op.path[i]);
+		}
+		std::size_t const index = op.path.back();
+		if (
+			!parent->is_type_of(VarMask::collection) ||
+			parent->size() < index ||
+			(PatchKind::insert != op.kind && parent->size() == index)
+		) {
+			return false;
+		}
+		auto& children = parent->children();
+		auto const it = children.begin() + static_cast<std::ptrdiff_t>(index);
+		switch (op.kind) {
+		case PatchKind::insert: children.insert(it, op.value); break;
+		case PatchKind::remove: children.erase(it); break;
+		case PatchKind::replace: *it = op.value; break;
+		}
+	}
+	return true;
+}
+
+/** @} */ // end of name-group Diff and patch
+
 /** @} */ // end of doc-group var
 
 } // namespace VarUtils
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "./config.hpp"
+#include "./Arena.hpp"
 
 #include <vector>
 #include <deque>
@@ -176,6 +176,7 @@
 	Allocator class for all auxiliary stdlib specializations.
 
 	@note Defaults to @c std::allocator.
+	@sa ArenaAllocator
 */
 #define DUCT_CONFIG_ALLOCATOR
 
@@ -0,0 +1,688 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief Arithmetic parsing.
+*/
+
+#pragma once
+
+#include "./../config.hpp"
+#include "./arithmetic_pow10.hpp"
+
+#include <type_traits>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+namespace duct {
+namespace detail {
+
+/**
+	@addtogroup text
+	@{
+*/
+
+namespace {
+
+static double const s_arithmetic_pow10[]{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+	1e21, 1e22
+};
+
+template<class CharT>
+inline bool
+arithmetic_digit(
+	CharT const c,
+	unsigned& digit
+) noexcept {
+	if (CharT('0') <= c && CharT('9') >= c) {
+		digit = static_cast<unsigned>(c - CharT('0'));
+		return true;
+	}
+	return false;
+}
+
+inline void
+arithmetic_multiply(
+	std::uint64_t const x,
+	std::uint64_t const y,
+	std::uint64_t& high,
+	std::uint64_t& low
+) noexcept {
+	std::uint64_t const x_low = x & 0xFFFFFFFFu;
+	std::uint64_t const x_high = x >> 32u;
+	std::uint64_t const y_low = y & 0xFFFFFFFFu;
+	std::uint64_t const y_high = y >> 32u;
+	std::uint64_t const low_low = x_low * y_low;
+	std::uint64_t const low_high = x_low * y_high;
+	std::uint64_t const high_low = x_high * y_low;
+	std::uint64_t const middle
+		= (low_low >> 32u)
+		+ (low_high & 0xFFFFFFFFu)
+		+ (high_low & 0xFFFFFFFFu)
+	;
+	high
+		= x_high * y_high
+		+ (low_high >> 32u)
+		+ (high_low >> 32u)
+		+ (middle >> 32u)
+	;
+	low = (middle << 32u) | (low_low & 0xFFFFFFFFu);
+}
+
+template<class T>
+inline bool
+arithmetic_eisel_lemire(
+	std::uint64_t,
+	signed long,
+	T&,
+	std::false_type
+) noexcept {
+	return false;
+}
+
+// Eisel-Lemire: the nearest T to mantissa * 10^exponent from the
+// product with the 128-bit power of ten. False if the product is too
+// close to a halfway value to decide, or if the result is subnormal
+// or overflows.
+template<class T>
+inline bool
+arithmetic_eisel_lemire(
+	std::uint64_t mantissa,
+	signed long const exponent,
+	T& value,
+	std::true_type
+) noexcept {
+	using limits = std::numeric_limits<T>;
+	enum : unsigned {
+		// Bits of the product below the mantissa and rounding bit
+		low_bits = 64u - limits::digits - 2u
+	};
+	std::uint64_t const low_mask = (std::uint64_t{1u} << low_bits) - 1u;
+	signed long const bias = limits::max_exponent - 1;
+	if (
+		arithmetic_pow10_128_min > exponent ||
+		arithmetic_pow10_128_max < exponent
+	) {
+		return false;
+	}
+	signed long leading_zeros = 0;
+	for (unsigned step = 32u; 0u < step; step >>= 1u) {
+		if (0u == (mantissa >> (64u - step))) {
+			mantissa <<= step;
+			leading_zeros += step;
+		}
+	}
+	// floor(exponent * log2(10)), with log2(10) in 16.16 fixed point
+	signed long const scaled = 217706 * exponent;
+	signed long result_exponent
+		= ((0 <= scaled) ? scaled / 65536 : -((65535 - scaled) / 65536))
+		+ 64 + bias - leading_zeros
+	;
+	auto const& power = arithmetic_pow10_128()[exponent - arithmetic_pow10_128_min];
+	std::uint64_t high;
+	std::uint64_t low;
+	arithmetic_multiply(mantissa, power[0u], high, low);
+	if (low_mask == (high & low_mask) && low + mantissa < mantissa) {
+		// Widen with the low half of the power
+		std::uint64_t extra_high;
+		std::uint64_t extra_low;
+		arithmetic_multiply(mantissa, power[1u], extra_high, extra_low);
+		std::uint64_t merged_high = high;
+		std::uint64_t const merged_low = low + extra_high;
+		if (merged_low < low) {
+			++merged_high;
+		}
+		if (
+			low_mask == (merged_high & low_mask) &&
+			~std::uint64_t{0u} == merged_low &&
+			extra_low + mantissa < mantissa
+		) {
+			return false;
+		}
+		high = merged_high;
+		low = merged_low;
+	}
+	unsigned const top = static_cast<unsigned>(high >> 63u);
+	std::uint64_t result = high >> (top + low_bits);
+	result_exponent -= 1u ^ top;
+	if (0u == low && 0u == (high & low_mask) && 1u == (result & 3u)) {
+		// Possibly halfway
+		return false;
+	}
+	// Round half to even
+	result += result & 1u;
+	result >>= 1u;
+	if (0u != (result >> limits::digits)) {
+		result >>= 1u;
+		++result_exponent;
+	}
+	if (0 >= result_exponent || 2 * limits::max_exponent - 1 <= result_exponent) {
+		return false;
+	}
+	value = std::ldexp(
+		static_cast<T>(result),
+		static_cast<int>(result_exponent - bias - (limits::digits - 1))
+	);
+	return true;
+}
+
+// Decimal for correctly rounded conversion by shifting (the "simple
+// decimal conversion" algorithm): the number is scaled by powers of
+// two until it is in [0.5, 1), then shifted by the mantissa width and
+// rounded. Digits past the capacity are dropped, and only affect
+// whether an apparent tie rounds up.
+struct ArithmeticDecimal final {
+	enum : unsigned {
+		capacity = 800u,
+		// Keeps the shift accumulators below 2^64
+		max_shift = 60u
+	};
+
+	// Digit values, with room for the digits a left shift adds
+	unsigned char digits[capacity + 20u];
+	// Number of digits
+	unsigned count{0u};
+	// Position of the decimal point; the value is 0.digits * 10^point
+	signed long point{0};
+	// Whether non-zero digits were dropped
+	bool truncated{false};
+
+	void
+	trim() noexcept {
+		while (0u < count && 0u == digits[count - 1u]) {
+			--count;
+		}
+		if (0u == count) {
+			point = 0;
+		}
+	}
+
+	// Multiply by 2^shift
+	void
+	shift_left(
+		unsigned const shift
+	) noexcept {
+		// Digits are written from the end, 20 places behind those
+		// read; a shift adds at most 19 digits
+		unsigned write = count + 20u;
+		std::uint64_t n = 0u;
+		for (unsigned read = count; 0u < read; --read) {
+			n += std::uint64_t{digits[read - 1u]} << shift;
+			std::uint64_t const quotient = n / 10u;
+			digits[--write] = static_cast<unsigned char>(n - 10u * quotient);
+			n = quotient;
+		}
+		while (0u < n) {
+			std::uint64_t const quotient = n / 10u;
+			digits[--write] = static_cast<unsigned char>(n - 10u * quotient);
+			n = quotient;
+		}
+		unsigned const new_count = count + 20u - write;
+		std::memmove(digits, digits + write, new_count);
+		point += static_cast<signed long>(new_count - count);
+		count = new_count;
+		for (; capacity < count; --count) {
+			truncated = truncated || 0u != digits[count - 1u];
+		}
+		trim();
+	}
+
+	// Divide by 2^shift
+	void
+	shift_right(
+		unsigned const shift
+	) noexcept {
+		unsigned read = 0u;
+		unsigned write = 0u;
+		std::uint64_t n = 0u;
+		for (; 0u == (n >> shift); ++read) {
+			if (count <= read) {
+				if (0u == n) {
+					count = 0u;
+					point = 0;
+					return;
+				}
+				for (; 0u == (n >> shift); ++read) {
+					n *= 10u;
+				}
+				break;
+			}
+			n = n * 10u + digits[read];
+		}
+		point -= static_cast<signed long>(read) - 1;
+		std::uint64_t const mask = (std::uint64_t{1u} << shift) - 1u;
+		for (; count > read; ++read) {
+			digits[write++] = static_cast<unsigned char>(n >> shift);
+			n = (n & mask) * 10u + digits[read];
+		}
+		while (0u < n) {
+			unsigned char const digit = static_cast<unsigned char>(n >> shift);
+			if (capacity > write) {
+				digits[write++] = digit;
+			} else {
+				truncated = truncated || 0u != digit;
+			}
+			n = (n & mask) * 10u;
+		}
+		count = write;
+		trim();
+	}
+
+	void
+	shift(
+		signed long amount
+	) noexcept {
+		for (; static_cast<signed long>(max_shift) < amount; amount -= max_shift) {
+			shift_left(max_shift);
+		}
+		for (; -static_cast<signed long>(max_shift) > amount; amount += max_shift) {
+			shift_right(max_shift);
+		}
+		if (0 < amount) {
+			shift_left(static_cast<unsigned>(amount));
+		} else if (0 > amount) {
+			shift_right(static_cast<unsigned>(-amount));
+		}
+	}
+
+	// Integer part, rounded half to even
+	template<class T>
+	T
+	rounded_integer() const noexcept {
+		T n{0};
+		signed long i = 0;
+		for (; point > i && static_cast<signed long>(count) > i; ++i) {
+			n = n * T(10) + T(digits[i]);
+		}
+		for (; point > i; ++i) {
+			n *= T(10);
+		}
+		if (0 <= point && static_cast<signed long>(count) > point) {
+			unsigned const next = digits[point];
+			bool const up
+				= (5u == next && static_cast<signed long>(count) == point + 1)
+				? truncated || (0 < point && 1u == (digits[point - 1] & 1u))
+				: 5u <= next
+			;
+			if (up) {
+				n += T(1);
+			}
+		}
+		return n;
+	}
+
+	// Convert to the nearest T; false on overflow
+	template<class T>
+	bool
+	to_floating(
+		T& value
+	) noexcept {
+		using limits = std::numeric_limits<T>;
+		static unsigned char const s_power_shift[]{
+			1u, 3u, 6u, 9u, 13u, 16u, 19u, 23u, 26u
+		};
+		enum : unsigned { power_shift_count = 9u };
+		trim();
+		if (0u == count || limits::min_exponent10 - limits::max_digits10 - 10 > point) {
+			value = T(0);
+			return true;
+		} else if (limits::max_exponent10 + 1 < point) {
+			return false;
+		}
+		signed long exponent = 0;
+		while (0 < point) {
+			unsigned const n
+				= (power_shift_count <= static_cast<unsigned long>(point))
+				? 27u : s_power_shift[static_cast<std::size_t>(point)]
+			;
+			shift_right(n);
+			exponent += static_cast<signed long>(n);
+		}
+		while (0 > point || (0 == point && 5u > digits[0u])) {
+			unsigned const n
+				= (power_shift_count <= static_cast<unsigned long>(-point))
+				? 27u : s_power_shift[static_cast<std::size_t>(-point)]
+			;
+			shift_left(n);
+			exponent -= static_cast<signed long>(n);
+		}
+		// Now in [0.5, 1); normal values are in [1, 2)
+		--exponent;
+		if (limits::min_exponent - 1 > exponent) {
+			shift(exponent - (limits::min_exponent - 1));
+			exponent = limits::min_exponent - 1;
+		}
+		if (limits::max_exponent <= exponent) {
+			return false;
+		}
+		shift(limits::digits);
+		T mantissa = rounded_integer<T>();
+		if (std::ldexp(T(1), limits::digits) <= mantissa) {
+			// Rounded up to the next power of two
+			mantissa /= T(2);
+			if (limits::max_exponent <= ++exponent) {
+				return false;
+			}
+		}
+		value = std::ldexp(mantissa, static_cast<int>(exponent - (limits::digits - 1)));
+		return true;
+	}
+};
+
+} // anonymous namespace
+
+/**
+	Whether a type is parsed by parse_arithmetic().
+
+	@note Character types and @c bool are not parsed as numbers.
+*/
+template<class T>
+struct is_parsed_arithmetic final
+	: public std::integral_constant<bool,
+		std::is_floating_point<T>::value || (
+			std::is_integral<T>::value &&
+			!std::is_same<T, bool>::value &&
+			!std::is_same<T, char>::value &&
+			!std::is_same<T, signed char>::value &&
+			!std::is_same<T, unsigned char>::value &&
+			!std::is_same<T, wchar_t>::value &&
+			!std::is_same<T, char16_t>::value &&
+			!std::is_same<T, char32_t>::value
+		)
+	>
+{};
+
+/**
+	Parse an integer.
+
+	@note The accepted form is <code>[+\-]?[0-9]+</code>. A minus sign
+	is not accepted for unsigned types.
+
+	@returns
+	- @c true if an integer was parsed (@a value is set and @a pos is
+	  advanced past it); or
+	- @c false if there was no integer at @a pos or the integer
+	  overflows @a T (@a value and @a pos are unchanged).
+	@param[in,out] pos Start of sequence.
+	@param end End of sequence.
+	@param[out] value Output value.
+*/
+template<class T, class ForwardIt>
+bool
+parse_integer(
+	ForwardIt& pos,
+	ForwardIt const end,
+	T& value
+) noexcept {
+	static_assert(
+		std::is_integral<T>::value,
+		"T must be integral"
+	);
+	using unsigned_type = typename std::make_unsigned<T>::type;
+	ForwardIt it = pos;
+	bool negative = false;
+	if (end != it && ('-' == *it || '+' == *it)) {
+		negative = '-' == *it;
+		if (negative && !std::is_signed<T>::value) {
+			return false;
+		}
+		++it;
+	}
+	unsigned_type const limit
+		= static_cast<unsigned_type>(std::numeric_limits<T>::max())
+		+ unsigned_type{negative}
+	;
+	unsigned_type acc = 0u;
+	unsigned digit;
+	ForwardIt const digits_begin = it;
+	for (; end != it && arithmetic_digit(*it, digit); ++it) {
+		if (acc > (limit - digit) / 10u) {
+			// Overflow
+			return false;
+		}
+		acc = static_cast<unsigned_type>(acc * 10u + digit);
+	}
+	if (digits_begin == it) {
+		return false;
+	} else if (!negative) {
+		value = static_cast<T>(acc);
+	} else if (limit == acc) {
+		value = std::numeric_limits<T>::min();
+	} else {
+		value = -static_cast<T>(acc);
+	}
+	pos = it;
+	return true;
+}
+
+/**
+	Parse a floating-point number.
+
+	@note The accepted form is
+	<code>[+\-]?([0-9]+(\.[0-9]*)?|\.[0-9]+)([eE][+\-]?[0-9]+)?</code>.
+	The result is correctly rounded (half to even) and does not
+	depend on the locale, and nothing is allocated. Values which can
+	be computed exactly in @a T are computed directly. Most others
+	are computed from a 128-bit power of ten (the Eisel-Lemire
+	algorithm; only for @c float and @c double). The rest are
+	converted from their digits by exact shifts.
+
+	@note Only the first 800 significant digits are kept. Later
+	digits only decide whether a value that appears to be exactly
+	halfway between two values of @a T rounds up. That is always
+	right for @c float and @c double, whose halfway values need
+	fewer digits. It may not be right for wider types.
+
+	@returns
+	- @c true if a number was parsed (@a value is set and @a pos is
+	  advanced past it); or
+	- @c false if there was no number at @a pos or the number
+	  overflows @a T (@a value and @a pos are unchanged).
+	  Underflow is not an error (@a value is set to zero or a
+	  subnormal value).
+	@param[in,out] pos Start of sequence.
+	@param end End of sequence.
+	@param[out] value Output value.
+*/
+template<class T, class ForwardIt>
+bool
+parse_floating(
+	ForwardIt& pos,
+	ForwardIt const end,
+	T& value
+) {
+	static_assert(
+		std::is_floating_point<T>::value,
+		"T must be floating-point"
+	);
+	enum : unsigned {
+		// Significant digits which always fit in 64 bits
+		max_digits = 19u,
+		// Largest exact power of ten (5^k < 2^mantissa_bits)
+		max_exact_exp = (24 >= std::numeric_limits<T>::digits) ? 10u : 22u
+	};
+	// Largest integer below which all integers are exact
+	std::uint64_t const max_exact_mantissa
+		= (64 > std::numeric_limits<T>::digits)
+		? std::uint64_t{1u} << (std::numeric_limits<T>::digits & 63)
+		: ~std::uint64_t{0u}
+	;
+	ForwardIt const begin = pos;
+	ForwardIt it = pos;
+	bool negative = false;
+	if (end != it && ('-' == *it || '+' == *it)) {
+		negative = '-' == *it;
+		++it;
+	}
+
+	std::uint64_t mantissa = 0u;
+	unsigned sig_digits = 0u;
+	signed long exponent = 0;
+	signed long written_exponent = 0;
+	bool truncated = false;
+	bool any_digits = false;
+	unsigned digit;
+	for (; end != it && arithmetic_digit(*it, digit); ++it) {
+		any_digits = true;
+		if (max_digits > sig_digits) {
+			if (0u != mantissa || 0u != digit) {
+				mantissa = mantissa * 10u + digit;
+				++sig_digits;
+			}
+		} else {
+			truncated = truncated || 0u != digit;
+			++exponent;
+		}
+	}
+	if (end != it && '.' == *it) {
+		++it;
+		for (; end != it && arithmetic_digit(*it, digit); ++it) {
+			any_digits = true;
+			if (max_digits > sig_digits) {
+				if (0u != mantissa || 0u != digit) {
+					mantissa = mantissa * 10u + digit;
+					++sig_digits;
+				}
+				--exponent;
+			} else {
+				truncated = truncated || 0u != digit;
+			}
+		}
+	}
+	if (!any_digits) {
+		return false;
+	}
+	if (end != it && ('e' == *it || 'E' == *it)) {
+		ForwardIt exp_it = it;
+		++exp_it;
+		bool exp_negative = false;
+		if (end != exp_it && ('-' == *exp_it || '+' == *exp_it)) {
+			exp_negative = '-' == *exp_it;
+			++exp_it;
+		}
+		if (end != exp_it && arithmetic_digit(*exp_it, digit)) {
+			signed long exp_value = 0;
+			for (; end != exp_it && arithmetic_digit(*exp_it, digit); ++exp_it) {
+				// Saturate; anything this large is out of range anyway
+				if (100000 > exp_value) {
+					exp_value = exp_value * 10 + static_cast<signed long>(digit);
+				}
+			}
+			written_exponent = exp_negative ? -exp_value : exp_value;
+			exponent += written_exponent;
+			it = exp_it;
+		}
+	}
+
+	// Eisel-Lemire is only implemented for IEEE 754 binary32 and
+	// binary64
+	using fast_conversion = std::integral_constant<bool,
+		std::numeric_limits<T>::is_iec559 &&
+		53 >= std::numeric_limits<T>::digits
+	>;
+	T result;
+	T upper;
+	if (0u == mantissa) {
+		value = negative ? -T(0) : T(0);
+	} else if (
+		!truncated &&
+		max_exact_mantissa >= mantissa &&
+		static_cast<signed long>(max_exact_exp) >= exponent &&
+		-static_cast<signed long>(max_exact_exp) <= exponent
+	) {
+		// Both operands are exact, so the result is correctly rounded
+		T const scale = static_cast<T>(
+			s_arithmetic_pow10[(0 > exponent) ? -exponent : exponent]
+		);
+		value = static_cast<T>(mantissa);
+		value = (0 > exponent) ? value / scale : value * scale;
+		if (negative) {
+			value = -value;
+		}
+	} else if (
+		arithmetic_eisel_lemire(mantissa, exponent, result, fast_conversion{}) && (
+			!truncated || (
+				// The digits are between mantissa and mantissa + 1
+				arithmetic_eisel_lemire(mantissa + 1u, exponent, upper, fast_conversion{}) &&
+				0 == std::memcmp(&result, &upper, sizeof(T))
+			)
+		)
+	) {
+		value = negative ? -result : result;
+	} else {
+		// Slow path: convert all of the digits exactly
+		ArithmeticDecimal decimal{};
+		bool fraction = false;
+		for (ForwardIt digit_it = begin; it != digit_it; ++digit_it) {
+			if ('.' == *digit_it) {
+				fraction = true;
+			} else if (arithmetic_digit(*digit_it, digit)) {
+				if (0u == decimal.count && 0u == digit) {
+					// Leading zero
+					if (fraction) {
+						--decimal.point;
+					}
+					continue;
+				} else if (!fraction) {
+					++decimal.point;
+				}
+				if (ArithmeticDecimal::capacity > decimal.count) {
+					decimal.digits[decimal.count++] = static_cast<unsigned char>(digit);
+				} else {
+					decimal.truncated = decimal.truncated || 0u != digit;
+				}
+			} else if ('e' == *digit_it || 'E' == *digit_it) {
+				break;
+			}
+		}
+		decimal.point += written_exponent;
+		if (!decimal.to_floating(result)) {
+			// Overflow
+			return false;
+		}
+		value = negative ? -result : result;
+	}
+	pos = it;
+	return true;
+}
+
+/**
+	Parse an integer or floating-point number from an entire sequence.
+
+	@returns @c true if the entire sequence is a number that fits in
+	@a T (@a value is set).
+	@param begin Start of sequence.
+	@param end End of sequence.
+	@param[out] value Output value.
+
+	@sa parse_integer(), parse_floating()
+*/
+template<class T, class ForwardIt>
+inline typename std::enable_if<std::is_integral<T>::value, bool>::type
+parse_arithmetic(
+	ForwardIt begin,
+	ForwardIt const end,
+	T& value
+) {
+	return parse_integer(begin, end, value) && end == begin;
+}
+
+/** @copydoc parse_arithmetic(ForwardIt,ForwardIt const,T&) */
+template<class T, class ForwardIt>
+inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+parse_arithmetic(
+	ForwardIt begin,
+	ForwardIt const end,
+	T& value
+) {
+	return parse_floating(begin, end, value) && end == begin;
+}
+
+/** @} */ // end of doc-group text
+
+} // namespace detail
+} // namespace duct
@@ -0,0 +1,96 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+@brief FNV-1a hashing.
+*/
+
+#pragma once
+
+#include "./../config.hpp"
+
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+namespace duct {
+namespace detail {
+
+/**
+	@addtogroup var
+	@{
+*/
+
+/**
+	FNV-1a parameters.
+
+	@tparam T Hash type; @c std::uint32_t or @c std::uint64_t.
+*/
+template<class T>
+struct fnv1a_params;
+
+/** @cond INTERNAL */
+template<>
+struct fnv1a_params<std::uint32_t> final {
+	static constexpr std::uint32_t const basis = 2166136261u;
+	static constexpr std::uint32_t const prime = 16777619u;
+};
+
+template<>
+struct fnv1a_params<std::uint64_t> final {
+	static constexpr std::uint64_t const basis = 14695981039346656037u;
+	static constexpr std::uint64_t const prime = 1099511628211u;
+};
+/** @endcond */ // INTERNAL
+
+/**
+	FNV-1a hash type as wide as @c std::size_t.
+*/
+using fnv1a_size_type = typename std::conditional<
+	8u <= sizeof(std::size_t),
+	std::uint64_t,
+	std::uint32_t
+>::type;
+
+/**
+	Hash bytes with FNV-1a.
+
+	@returns The hash of @a data, continued from @a hash.
+	@tparam T Hash type; @c std::uint32_t or @c std::uint64_t.
+	@param data Data.
+	@param size Size of @a data in bytes.
+	@param hash Hash to continue from; the offset basis by default.
+*/
+template<class T>
+inline T
+fnv1a(
+	void const* const data,
+	std::size_t const size,
+	T hash = fnv1a_params<T>::basis
+) noexcept {
+	auto const* const bytes = static_cast<unsigned char const*>(data);
+	for (std::size_t i = 0u; size > i; ++i) {
+		hash = (hash ^ bytes[i]) * fnv1a_params<T>::prime;
+	}
+	return hash;
+}
+
+/**
+	Hash bytes with FNV-1a for hash containers.
+
+	@returns The @c fnv1a_size_type hash of @a data.
+	@param data Data.
+	@param size Size of @a data in bytes.
+*/
+inline std::size_t
+fnv1a_size(
+	void const* const data,
+	std::size_t const size
+) noexcept {
+	return static_cast<std::size_t>(fnv1a<fnv1a_size_type>(data, size));
+}
+
+/** @} */ // end of doc-group var
+
+} // namespace detail
+} // namespace duct
@@ -12,6 +12,11 @@
 #include "./../string.hpp"
 #include "./../VarType.hpp"
 
+#if defined(DUCT_CONFIG_VAR_INTERN_NAMES) \
+	&& (0 != DUCT_CONFIG_VAR_INTERN_NAMES)
+	#include "./../NamePool.hpp"
+#endif
+
 #include <type_traits>
 
 namespace duct {
@@ -37,6 +42,67 @@ namespace detail {
 	#define DUCT_CONFIG_VAR_LARGE_NUMERIC_TYPES 0
 #endif
 
+#ifndef DUCT_CONFIG_VAR_INTERN_NAMES
+	/**
+		@ingroup config
+
+		Whether to intern Var names.
+
+		@note With this enabled, names are InternedName handles into
+		the shared NamePool: equal names share storage, and comparing
+		names for equality (as by Var::compare() and
+		VarTemplate::validate_identity()) is a pointer comparison.
+		Names are never freed from the pool.
+
+		@note Defaults to 0.
+
+		@sa var_config
+	*/
+	#define DUCT_CONFIG_VAR_INTERN_NAMES 0
+#endif
+
+#ifndef DUCT_CONFIG_VAR_INDEX_THRESHOLD
+	/**
+		@ingroup config
+
+		Minimum number of children for Var::find() and
+		Var::find_all() to search a collection through a hash index
+		instead of a linear scan.
+
+		@note Defaults to 8.
+
+		@sa Var::find(u8string const&)
+	*/
+	#define DUCT_CONFIG_VAR_INDEX_THRESHOLD 8u
+#endif
+
+#ifndef DUCT_CONFIG_VAR_COPY_ON_WRITE
+	/**
+		@ingroup config
+
+		Whether Var child collections are shared between copies.
+
+		@note With this enabled, copying a Var shares its child
+		collection (by reference count) instead of copying the
+		subtree. A shared collection is copied by the first operation
+		that may modify it, including non-const access to the
+		children; as each child copy shares its own collection in turn,
+		a modification copies only the collections on the path from
+		the modified Var to the root of the copy. String values are
+		still copied.
+
+		@warning References to children taken before a copy refer to
+		the shared collection, so modifying through them is visible
+		in every copy. Copies also share the original's storage, so
+		an Arena must outlive copies of the Vars allocated in it.
+
+		@note Defaults to 0.
+
+		@sa var_config
+	*/
+	#define DUCT_CONFIG_VAR_COPY_ON_WRITE 0
+#endif
+
 /**
 	Var configuration.
 */
@@ -44,8 +110,17 @@ struct var_config final
 	: public traits::restrict_all
 {
 public:
-	/** typename for Var names */
+#if (0 == DUCT_CONFIG_VAR_INTERN_NAMES) \
+	|| defined(DOXYGEN_CONSISTS_SOLELY_OF_UNICORNS_AND_CONFETTI)
+	/**
+		typename for Var names.
+		@c u8string by default; InternedName
+		with #DUCT_CONFIG_VAR_INTERN_NAMES.
+	*/
 	using name_type = u8string;
+#else
+	using name_type = InternedName;
+#endif
 	/** typename for @c VarType::string */
 	using string_type = u8string;
 
@@ -0,0 +1,404 @@
+/**
+@copyright MIT license; see @ref index or the accompanying LICENSE file.
+
+@file
+*/
+
+namespace {
+
+inline void
+binary_put_varint(
+	aux::vector<char>& data,
+	std::uint64_t value
+) {
+	while (0x80u <= value) {
+		data.push_back(static_cast<char>(0x80u | (value & 0x7Fu)));
+		value >>= 7u;
+	}
+	data.push_back(static_cast<char>(value));
+}
+
+inline bool
+binary_get_varint(
+	char const*& pos,
+	char const* const end,
+	std::uint64_t& value
+) noexcept {
+	value = 0u;
+	for (unsigned shift = 0u; 64u > shift; shift += 7u) {
+		if (end == pos) {
+			return false;
+		}
+		std::uint64_t const byte = static_cast<unsigned char>(*pos++);
+		value |= (byte & 0x7Fu) << shift;
+		if (0u == (byte & 0x80u)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template<class T>
+inline void
+binary_put_raw(
+	aux::vector<char>& data,
+	T value,
+	Endian const endian
+) {
+	byte_swap_ref_if(value, endian);
+	char const* const bytes = reinterpret_cast<char const*>(&value);
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template<class T>
+inline bool
+binary_get_raw(
+	char const*& pos,
+	char const* const end,
+	T& value,
+	Endian const endian
+) noexcept {
+	if (sizeof(T) > static_cast<std::size_t>(end - pos)) {
+		return false;
+	}
+	std::memcpy(&value, pos, sizeof(T));
+	byte_swap_ref_if(value, endian);
+	pos += sizeof(T);
+	return true;
+}
+
+} // anonymous namespace
+
+// class BinaryWriter implementation
+
+std::uint32_t
+BinaryWriter::string_index(
+	u8string const& str
+) {
+	auto const result = m_string_index.emplace(
+		StringRef{str.data(), str.size()},
+		static_cast<std::uint32_t>(m_strings.size())
+	);
+	if (result.second) {
+		m_strings.push_back(result.first->first);
+	}
+	return result.first->second;
+}
+
+void
+BinaryWriter::add_names(
+	Var const& var
+) {
+	u8string const& name = var.name();
+	if (!name.empty()) {
+		string_index(name);
+	}
+	if (var.is_type_of(VarMask::collection)) {
+		for (auto const& child : var) {
+			add_names(child);
+		}
+	}
+}
+
+void
+BinaryWriter::encode(
+	Var const& var
+) {
+	binary::Tag tag = binary::Tag::null;
+	switch (var.type()) {
+	case VarType::null: tag = binary::Tag::null; break;
+	case VarType::string: tag = binary::Tag::string; break;
+	case VarType::integer: tag = binary::Tag::integer; break;
+	case VarType::decimal: tag = binary::Tag::decimal; break;
+	case VarType::boolean:
+		tag = var.boolean()
+			? binary::Tag::boolean_true
+			: binary::Tag::boolean_false
+		;
+		break;
+	case VarType::array: tag = binary::Tag::array; break;
+	case VarType::node: tag = binary::Tag::node; break;
+	case VarType::identifier: tag = binary::Tag::identifier; break;
+	}
+	m_tree_data.push_back(static_cast<char>(tag));
+	u8string const& name = var.name();
+	binary_put_varint(
+		m_tree_data,
+		name.empty() ? 0u : std::uint64_t{string_index(name)} + 1u
+	);
+	switch (var.type()) {
+	case VarType::string:
+		binary_put_varint(m_tree_data, string_index(var.string_ref()));
+		break;
+
+	case VarType::integer: {
+		// Zigzag, so that small negative values are short
+		std::int64_t const value = var.integer();
+		binary_put_varint(
+			m_tree_data,
+			(static_cast<std::uint64_t>(value) << 1u) ^
+			static_cast<std::uint64_t>(value >> 63)
+		);
+	}	break;
+
+	case VarType::decimal:
+		binary_put_raw(m_tree_data, var.decimal(), m_stream_ctx.endian());
+		break;
+
+	case VarType::array:
+	case VarType::node:
+	case VarType::identifier:
+		binary_put_varint(m_tree_data, var.size());
+		for (auto const& child : var) {
+			encode(child);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+bool
+BinaryWriter::write(
+	std::ostream& dest,
+	Var const& source
+) {
+	m_string_index.clear();
+	m_strings.clear();
+	m_string_data.clear();
+	m_tree_data.clear();
+
+	// Names first, so the reader can build them up front
+	add_names(source);
+	std::size_t const name_count = m_strings.size();
+	encode(source);
+	for (auto const& str : m_strings) {
+		binary_put_varint(m_string_data, str.size);
+		m_string_data.insert(m_string_data.end(), str.data, str.data + str.size);
+	}
+	m_string_index.clear();
+	if (
+		0xFFFFFFFFu < m_strings.size() ||
+		0xFFFFFFFFu < m_string_data.size() ||
+		0xFFFFFFFFu < m_tree_data.size()
+	) {
+		return false;
+	}
+
+	std::uint8_t const header[]{
+		static_cast<std::uint8_t>(binary::MAGIC[0u]),
+		static_cast<std::uint8_t>(binary::MAGIC[1u]),
+		static_cast<std::uint8_t>(binary::MAGIC[2u]),
+		static_cast<std::uint8_t>(binary::MAGIC[3u]),
+		binary::VERSION,
+		static_cast<std::uint8_t>(
+			(Endian::big == m_stream_ctx.endian()) ? 1u : 0u
+		),
+		static_cast<std::uint8_t>(sizeof(detail::var_config::decimal_type)),
+		0u
+	};
+	std::uint32_t const sizes[]{
+		static_cast<std::uint32_t>(name_count),
+		static_cast<std::uint32_t>(m_strings.size()),
+		static_cast<std::uint32_t>(m_string_data.size()),
+		static_cast<std::uint32_t>(m_tree_data.size())
+	};
+	m_stream_ctx.write_arithmetic_array(dest, header, sizeof(header));
+	m_stream_ctx.write_arithmetic_array(dest, sizes, 4u);
+	m_stream_ctx.write_arithmetic_array(
+		dest, m_string_data.data(), m_string_data.size()
+	);
+	m_stream_ctx.write_arithmetic_array(
+		dest, m_tree_data.data(), m_tree_data.size()
+	);
+	return dest.good();
+}
+
+// class BinaryReader implementation
+
+bool
+BinaryReader::decode(
+	char const*& pos,
+	char const* const end,
+	Var& parent,
+	unsigned const depth
+) {
+	using name_type = detail::var_config::name_type;
+	static name_type const s_empty_name{};
+
+	if (end == pos) {
+		return false;
+	}
+	auto const tag = static_cast<binary::Tag>(*pos++);
+	std::uint64_t index;
+	if (!binary_get_varint(pos, end, index) || m_names.size() < index) {
+		return false;
+	}
+	name_type const& name = (0u == index) ? s_empty_name : m_names[index - 1u];
+	std::uint64_t value;
+	switch (tag) {
+	case binary::Tag::null:
+		parent.emplace_back(name, VarType::null);
+		break;
+
+	case binary::Tag::string:
+		if (!binary_get_varint(pos, end, value) || m_strings.size() <= value) {
+			return false;
+		}
+		parent.emplace_back(name, detail::var_config::string_type{
+			m_strings[value].data, m_strings[value].size
+		});
+		break;
+
+	case binary::Tag::integer: {
+		if (!binary_get_varint(pos, end, value)) {
+			return false;
+		}
+		using integer_type = detail::var_config::integer_type;
+		std::int64_t const decoded
+			= static_cast<std::int64_t>(value >> 1u)
+			^ -static_cast<std::int64_t>(value & 1u)
+		;
+		if (static_cast<integer_type>(decoded) != decoded) {
+			return false;
+		}
+		parent.emplace_back(name, static_cast<integer_type>(decoded));
+	}	break;
+
+	case binary::Tag::decimal: {
+		using decimal_type = detail::var_config::decimal_type;
+		Endian const endian = m_stream_ctx.endian();
+		if (4u == m_decimal_size) {
+			float decoded;
+			if (!binary_get_raw(pos, end, decoded, endian)) {
+				return false;
+			}
+			parent.emplace_back(name, static_cast<decimal_type>(decoded));
+		} else {
+			double decoded;
+			if (!binary_get_raw(pos, end, decoded, endian)) {
+				return false;
+			}
+			parent.emplace_back(name, static_cast<decimal_type>(decoded));
+		}
+	}	break;
+
+	case binary::Tag::boolean_false:
+	case binary::Tag::boolean_true:
+		parent.emplace_back(name, binary::Tag::boolean_true == tag);
+		break;
+
+	case binary::Tag::array:
+	case binary::Tag::node:
+	case binary::Tag::identifier: {
+		// Every child takes at least two bytes
+		if (
+			m_max_depth <= depth ||
+			!binary_get_varint(pos, end, value) ||
+			static_cast<std::uint64_t>(end - pos) / 2u < value
+		) {
+			return false;
+		}
+		parent.emplace_back(
+			name,
+			(binary::Tag::array == tag)
+				? VarType::array
+			: (binary::Tag::node == tag)
+				? VarType::node
+				: VarType::identifier
+		);
+		Var& collection = parent.back();
+		collection.children().reserve(static_cast<std::size_t>(value));
+		for (; 0u < value; --value) {
+			if (!decode(pos, end, collection, depth + 1u)) {
+				return false;
+			}
+		}
+	}	break;
+
+	default:
+		return false;
+	}
+	return true;
+}
+
+bool
+BinaryReader::read(
+	std::istream& src,
+	Var& dest
+) {
+	std::uint8_t header[8u];
+	IO::read_arithmetic_array(src, header, 8u);
+	if (
+		src.fail() ||
+		0 != std::memcmp(header, binary::MAGIC, 4u) ||
+		binary::VERSION != header[4u] ||
+		1u < header[5u] ||
+		(4u != header[6u] && 8u != header[6u])
+	) {
+		return false;
+	}
+	m_stream_ctx.set_endian((0u == header[5u]) ? Endian::little : Endian::big);
+	m_decimal_size = header[6u];
+
+	std::uint32_t sizes[4u];
+	m_stream_ctx.read_arithmetic_array(src, sizes, 4u);
+	std::uint32_t const name_count = sizes[0u];
+	std::uint32_t const string_count = sizes[1u];
+	std::size_t const string_size = sizes[2u];
+	std::size_t const tree_size = sizes[3u];
+	// Every string takes at least one byte
+	if (src.fail() || name_count > string_count || string_count > string_size) {
+		return false;
+	}
+
+	// The sizes are not trusted: read in growing blocks so that a
+	// short stream fails before a large allocation
+	std::size_t const total = string_size + tree_size;
+	m_data.clear();
+	while (total > m_data.size()) {
+		std::size_t const offset = m_data.size();
+		std::size_t const block = std::min(
+			total - offset, std::max(offset, std::size_t{0x10000u})
+		);
+		m_data.resize(offset + block);
+		m_stream_ctx.read_arithmetic_array(src, m_data.data() + offset, block);
+		if (src.fail()) {
+			return false;
+		}
+	}
+
+	char const* pos = m_data.data();
+	char const* const strings_end = pos + string_size;
+	m_strings.clear();
+	m_names.clear();
+	m_strings.reserve(string_count);
+	m_names.reserve(name_count);
+	for (std::uint32_t i = 0u; string_count > i; ++i) {
+		std::uint64_t size;
+		if (
+			!binary_get_varint(pos, strings_end, size) ||
+			static_cast<std::uint64_t>(strings_end - pos) < size
+		) {
+			return false;
+		}
+		m_strings.push_back(StringRef{pos, static_cast<std::size_t>(size)});
+		if (name_count > i) {
+			m_names.emplace_back(pos, static_cast<std::size_t>(size));
+		}
+		pos += size;
+	}
+	if (strings_end != pos) {
+		return false;
+	}
+
+	// Decode into a holder so that dest is untouched on failure
+	Var holder{VarType::node};
+	char const* const end = strings_end + tree_size;
+	if (!decode(pos, end, holder, 0u) || end != pos) {
+		return false;
+	}
+	dest = std::move(holder.back());
+	return true;
+}
@@ -69,7 +69,24 @@ get_token_name(
 	}
 }
 
-static CharacterSet const
+VarType
+get_token_value_type(
+	signed const type
+) noexcept {
+	switch (type) {
+	case TOK_INTEGER: return VarType::integer;
+	case TOK_FLOATING: return VarType::decimal;
+	case TOK_LITERAL_TRUE:
+	case TOK_LITERAL_FALSE: return VarType::boolean;
+	case TOK_LITERAL_NULL: return VarType::null;
+	default: return VarType::string;
+	}
+}
+
+// Name of nameless values and collections
+static CharBuf const s_nameless{};
+
+static constexpr ASCIICharacterSet
 	s_set_whitespace{"\t "},
 	s_set_sign{"\\-+"},
 	s_set_numeral{"0-9"},
@@ -87,6 +104,146 @@ static char32 const
 	s_lit_false[]{'f','a','l','s','e'},
 	s_lit_null[]{'n','u','l','l'}
 ;
+
+// Table-driven lexer
+
+// Byte classes
+enum : std::uint8_t {
+	LC_O, // Other
+	LC_D, // Digit
+	LC_P, // Decimal point
+	LC_S, // Space or tab
+	LC_N, // Linefeed
+	LC_T, // Functor
+	LC_Q, // Quotation mark
+	LC_L, // Slash
+	LC_B, // Backslash
+	LC_R, // Carriage return
+	LC_H, // Non-ASCII unit
+	LC_E, // EOF (never in the class table)
+
+	LC_COUNT
+};
+
+static std::uint8_t const s_lex_class[256]{
+//	0     1     2     3     4     5     6     7     8     9     A     B     C     D     E     F
+	LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_S, LC_N, LC_O, LC_O, LC_R, LC_O, LC_O, // 0
+	LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, // 1
+	LC_S, LC_O, LC_Q, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_T, LC_O, LC_P, LC_L, // 2
+	LC_D, LC_D, LC_D, LC_D, LC_D, LC_D, LC_D, LC_D, LC_D, LC_D, LC_O, LC_O, LC_O, LC_T, LC_O, LC_O, // 3
+	LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, // 4
+	LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_T, LC_B, LC_T, LC_O, LC_O, // 5
+	LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, // 6
+	LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_O, LC_T, LC_O, LC_T, LC_O, LC_O, // 7
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, // 8
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, // 9
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, // A
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, // B
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, // C
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, // D
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, // E
+	LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H, LC_H  // F
+};
+
+// States; equivalent to the read_tok_*() function reading the token
+enum : std::uint8_t {
+	LS_STRING,
+	LS_INTEGER,
+	LS_FLOATING,
+	LS_QUOTED,
+
+	LS_COUNT
+};
+
+// Actions (high nibble of a transition)
+enum : std::uint8_t {
+	// Buffer and switch to state; byte runs are consumed in bulk
+	LA_CONTINUE = 0x00,
+	// Token ends before the current code point
+	LA_END = 0x10,
+	// Buffer and switch to state (code point is not a plain byte)
+	LA_PLAIN = 0x20,
+	// Slash; ends token if it starts a comment, otherwise LA_PLAIN
+	LA_SLASH = 0x30,
+	// Hand the rest of the token to the read_tok_*() function
+	LA_DELEGATE = 0x40,
+
+	LA_MASK = 0xF0
+};
+
+#define DUCT_SP_LT_(action_, state_) (LA_ ## action_ | LS_ ## state_)
+
+static std::uint8_t const s_lex_transition[LS_COUNT][LC_COUNT]{
+// LS_STRING
+{
+	DUCT_SP_LT_(CONTINUE, STRING), // LC_O
+	DUCT_SP_LT_(CONTINUE, STRING), // LC_D
+	DUCT_SP_LT_(CONTINUE, STRING), // LC_P
+	DUCT_SP_LT_(END, STRING), // LC_S
+	DUCT_SP_LT_(END, STRING), // LC_N
+	DUCT_SP_LT_(END, STRING), // LC_T
+	DUCT_SP_LT_(DELEGATE, STRING), // LC_Q
+	DUCT_SP_LT_(SLASH, STRING), // LC_L
+	DUCT_SP_LT_(DELEGATE, STRING), // LC_B
+	DUCT_SP_LT_(PLAIN, STRING), // LC_R
+	DUCT_SP_LT_(PLAIN, STRING), // LC_H
+	DUCT_SP_LT_(END, STRING), // LC_E
+},
+// LS_INTEGER
+{
+	DUCT_SP_LT_(CONTINUE, STRING),
+	DUCT_SP_LT_(CONTINUE, INTEGER),
+	DUCT_SP_LT_(CONTINUE, FLOATING),
+	DUCT_SP_LT_(END, INTEGER),
+	DUCT_SP_LT_(END, INTEGER),
+	DUCT_SP_LT_(END, INTEGER),
+	DUCT_SP_LT_(DELEGATE, INTEGER),
+	DUCT_SP_LT_(SLASH, STRING),
+	DUCT_SP_LT_(DELEGATE, INTEGER),
+	DUCT_SP_LT_(PLAIN, STRING),
+	DUCT_SP_LT_(PLAIN, STRING),
+	DUCT_SP_LT_(END, INTEGER),
+},
+// LS_FLOATING
+{
+	DUCT_SP_LT_(CONTINUE, STRING),
+	DUCT_SP_LT_(CONTINUE, FLOATING),
+	DUCT_SP_LT_(CONTINUE, STRING),
+	DUCT_SP_LT_(END, FLOATING),
+	DUCT_SP_LT_(END, FLOATING),
+	DUCT_SP_LT_(END, FLOATING),
+	DUCT_SP_LT_(DELEGATE, FLOATING),
+	DUCT_SP_LT_(SLASH, STRING),
+	DUCT_SP_LT_(DELEGATE, FLOATING),
+	DUCT_SP_LT_(PLAIN, STRING),
+	DUCT_SP_LT_(PLAIN, STRING),
+	DUCT_SP_LT_(END, FLOATING),
+},
+// LS_QUOTED
+{
+	DUCT_SP_LT_(CONTINUE, QUOTED),
+	DUCT_SP_LT_(CONTINUE, QUOTED),
+	DUCT_SP_LT_(CONTINUE, QUOTED),
+	DUCT_SP_LT_(CONTINUE, QUOTED),
+	DUCT_SP_LT_(DELEGATE, QUOTED),
+	DUCT_SP_LT_(CONTINUE, QUOTED),
+	DUCT_SP_LT_(END, QUOTED),
+	DUCT_SP_LT_(CONTINUE, QUOTED),
+	DUCT_SP_LT_(DELEGATE, QUOTED),
+	DUCT_SP_LT_(PLAIN, QUOTED),
+	DUCT_SP_LT_(PLAIN, QUOTED),
+	DUCT_SP_LT_(DELEGATE, QUOTED),
+},
+};
+
+#undef DUCT_SP_LT_
+
+static signed const s_lex_token_type[LS_COUNT]{
+	TOK_STRING,
+	TOK_INTEGER,
+	TOK_FLOATING,
+	TOK_STRING_QUOTED
+};
 } // anonymous namespace
 
 #define DUCT_SP_THROW_(fmt_) \
@@ -122,7 +279,9 @@ ScriptParserException::ScriptParserException(
 	if (m_parser && !m_token) {
 		m_token = &(m_parser->token());
 	}
-	if (m_token) {
+	if (m_token && m_parser) {
+		m_parser->token_position(*m_token, start_line, start_column);
+	} else if (m_token) {
 		start_line = m_token->line();
 		start_column = m_token->column();
 	}
@@ -160,8 +319,16 @@ void
 ScriptParser::reset() noexcept {
 	Parser::reset();
 	m_stack.clear();
+	m_handler = nullptr;
 	m_states.clear();
 	m_token_ident.reset(NULL_TOKEN, true);
+	m_feed_buffer.clear();
+	m_feed_scanned = 0u;
+	m_feed_state = ScanState::normal;
+	m_feeding = false;
+	m_deferred = nullptr;
+	m_defer_depth = 0u;
+	m_defer_count = 0u;
 }
 
 void
@@ -184,34 +351,555 @@ ScriptParser::finish() {
 void
 ScriptParser::skip_whitespace() {
 	while (CHAR_EOF != m_curchar && s_set_whitespace.contains(m_curchar)) {
+		if (use_table_lexer()) {
+			// Skip the following run of whitespace bytes
+			char const* pos = m_source_pos;
+			while (m_source_end != pos && LC_S == s_lex_class[
+				static_cast<char8_strict>(*pos)
+			]) {
+				++pos;
+			}
+			m_source_pos = pos;
+		}
 		next_char();
 	}
 }
 
 bool
 ScriptParser::process(
-	Var& node,
+	ScriptHandler& handler,
 	std::istream& stream
 ) {
 	if (initialize(stream)) {
-		node.morph(VarType::node, false); // Make sure variable is a node
-		push(node);
-		do {} while (parse());
-		finish();
-		if (!at_root()) {
-			DUCT_SP_THROWF_NO_INFO_(
-				"Unclosed collection at EOF: %lu deep in %s scope",
-				static_cast<unsigned long>(m_stack.size()),
-				var_type_name(m_stack.back()->type())
-			);
+		process_all(handler);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+bool
+ScriptParser::process(
+	ScriptHandler& handler,
+	char const* const begin,
+	char const* const end
+) {
+	if (initialize(begin, end)) {
+		process_all(handler);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+bool
+ScriptParser::process_file(
+	ScriptHandler& handler,
+	char const* const path
+) {
+	IO::MappedFile const file{path};
+	if (file.is_open()) {
+		return process(handler, file.begin(), file.end());
+	} else {
+		return false;
+	}
+}
+
+void
+ScriptParser::process_all(
+	ScriptHandler& handler
+) {
+	Arena::Scope const scope{
+		(nullptr != m_arena) ? m_arena : Arena::current()
+	};
+	m_handler = &handler;
+	push(VarType::node); // Root
+	do {} while (parse());
+	end_process();
+}
+
+void
+ScriptParser::end_process() {
+	finish();
+	if (!at_root()) {
+		DUCT_SP_THROWF_NO_INFO_(
+			"Unclosed collection at EOF: %lu deep in %s scope",
+			static_cast<unsigned long>(m_stack.size()),
+			var_type_name(current_scope())
+		);
+	}
+	reset();
+}
+
+void
+ScriptParser::begin_feed(
+	ScriptHandler& handler
+) {
+	reset();
+	m_handler = &handler;
+	push(VarType::node); // Root
+	m_feeding = true;
+}
+
+void
+ScriptParser::feed(
+	char const* const data,
+	std::size_t const size
+) {
+	DUCT_DEBUG_ASSERTP(m_feeding, this, "begin_feed() must be called first");
+	m_feed_buffer.insert(m_feed_buffer.end(), data, data + size);
+	std::size_t const split = scan_feed();
+	if (0u == split) {
+		return;
+	}
+	Arena::Scope const scope{
+		(nullptr != m_arena) ? m_arena : Arena::current()
+	};
+	char const* const begin = m_feed_buffer.data();
+	continue_source(begin, begin + split);
+	for (;;) {
+		skip_whitespace();
+		if (
+			CHAR_EOF == m_curchar ||
+			// An EOL token is handled after the following code point
+			// is read, so leave a trailing newline for the next data
+			(CHAR_NEWLINE == m_curchar && m_source_end == m_source_pos)
+		) {
+			break;
 		}
-		reset();
+		discern_token();
+		read_token();
+	}
+	// Tokens can outlive the data they were read from
+	m_token.buffer().detach();
+	m_token_ident.buffer().detach();
+	resolve_position();
+	resolve_token(m_token_ident);
+	m_feed_buffer.erase(
+		m_feed_buffer.begin(),
+		m_feed_buffer.begin() + static_cast<std::ptrdiff_t>(split)
+	);
+	m_feed_scanned -= split;
+}
+
+void
+ScriptParser::end_feed() {
+	DUCT_DEBUG_ASSERTP(m_feeding, this, "begin_feed() must be called first");
+	Arena::Scope const scope{
+		(nullptr != m_arena) ? m_arena : Arena::current()
+	};
+	char const* const begin = m_feed_buffer.data();
+	continue_source(begin, begin + m_feed_buffer.size());
+	do {} while (parse());
+	end_process();
+}
+
+ScriptParser::ScanEvent
+ScriptParser::scan_char(
+	ScanState& state,
+	char32 const cp
+) noexcept {
+	// Track just enough lexical state to find whitespace that
+	// separates tokens; data up to it can be parsed without needing
+	// any of the data after it
+	if (CHAR_SENTINEL == cp) {
+		// Skipped by next_char() and peek_char()
+		return ScanEvent::none;
+	} else if (CHAR_CARRIAGERETURN == cp) {
+		// Skipped by next_char(), but not by peek_char()
+		if (ScanState::slash == state) {
+			state = ScanState::normal;
+		}
+		return ScanEvent::none;
+	}
+	switch (state) {
+	case ScanState::slash:
+		if (CHAR_SLASH == cp) {
+			state = ScanState::comment;
+			break;
+		} else if (CHAR_ASTERISK == cp) {
+			// The asterisk also counts towards the terminator
+			state = ScanState::comment_block_star;
+			break;
+		}
+		state = ScanState::normal;
+		// fall-through
+
+	case ScanState::normal:
+		switch (cp) {
+		case CHAR_QUOTE: state = ScanState::quoted; break;
+		case CHAR_BACKSLASH: state = ScanState::escape; break;
+		case CHAR_SLASH: state = ScanState::slash; break;
+		case CHAR_NEWLINE: return ScanEvent::newline;
+		case CHAR_OPENBRACE:
+		case CHAR_OPENBRACKET: return ScanEvent::open;
+		case CHAR_CLOSEBRACE:
+		case CHAR_CLOSEBRACKET: return ScanEvent::close;
+		default:
+			if (s_set_whitespace.contains(cp)) {
+				return ScanEvent::blank;
+			}
+			break;
+		}
+		break;
+
+	case ScanState::escape:
+		state = ScanState::normal;
+		break;
+
+	case ScanState::quoted:
+		if (CHAR_BACKSLASH == cp) {
+			state = ScanState::quoted_escape;
+		} else if (CHAR_QUOTE == cp) {
+			state = ScanState::normal;
+		}
+		break;
+
+	case ScanState::quoted_escape:
+		state = ScanState::quoted;
+		break;
+
+	case ScanState::comment:
+		if (CHAR_NEWLINE == cp) {
+			state = ScanState::normal;
+			return ScanEvent::newline;
+		}
+		break;
+
+	case ScanState::comment_block:
+		if (CHAR_ASTERISK == cp) {
+			state = ScanState::comment_block_star;
+		}
+		break;
+
+	case ScanState::comment_block_star:
+		if (CHAR_SLASH == cp) {
+			state = ScanState::normal;
+		} else if (CHAR_ASTERISK != cp) {
+			state = ScanState::comment_block;
+		}
+		break;
+	}
+	return ScanEvent::none;
+}
+
+std::size_t
+ScriptParser::scan_feed() {
+	char const* const begin = m_feed_buffer.data();
+	char const* const end = begin + m_feed_buffer.size();
+	char const* pos = begin + m_feed_scanned;
+	char const* split = begin;
+	char32 cp;
+	while (end != pos) {
+		char const* const next = UTF8Utils::decode(pos, end, cp, CHAR_SENTINEL);
+		if (next == pos) {
+			// Incomplete sequence; wait for more data
+			break;
+		}
+		pos = next;
+		switch (scan_char(m_feed_state, cp)) {
+		case ScanEvent::blank:
+		case ScanEvent::newline:
+			split = pos;
+			break;
+		default:
+			break;
+		}
+	}
+	m_feed_scanned = static_cast<std::size_t>(pos - begin);
+	return static_cast<std::size_t>(split - begin);
+}
+
+bool
+ScriptParser::process_deferred(
+	Var& node,
+	char const* const begin,
+	char const* const end,
+	deferred_vector_type& deferred
+) {
+	if (initialize(begin, end)) {
+		m_builder.reset(node);
+		m_deferred = &deferred;
+		m_defer_depth = 1u;
+		m_defer_count = node.size();
+		process_all(m_builder);
 		return true;
 	} else {
 		return false;
 	}
 }
 
+void
+ScriptParser::process_deferred(
+	Var& node,
+	DeferredNode const& body,
+	deferred_vector_type& deferred
+) {
+	initialize(body.begin, body.end);
+	// Position of the first code point of the body
+	set_position(body.line, body.column);
+	m_builder.reset(node);
+	m_deferred = &deferred;
+	m_defer_depth = 2u;
+	m_defer_count = node.size();
+	Arena::Scope const scope{
+		(nullptr != m_arena) ? m_arena : Arena::current()
+	};
+	m_handler = &m_builder;
+	push(VarType::node); // Root
+	// The body's node was begun by the builder's reset(); the body
+	// ends with its close-brace
+	push(VarType::node);
+	do {} while (parse());
+	end_process();
+}
+
+void
+ScriptParser::defer_node() {
+	if (CHAR_EOF == m_curchar) {
+		return;
+	}
+	ScanState state = ScanState::normal;
+	signed depth = 0;
+	char32 cp = m_curchar;
+	char const* cur = m_source_cur;
+	char const* pos = m_source_pos;
+	for (;;) {
+		switch (scan_char(state, cp)) {
+		case ScanEvent::open:
+			++depth;
+			break;
+
+		case ScanEvent::close:
+			if (0 < depth) {
+				--depth;
+				break;
+			} else if (CHAR_CLOSEBRACE != cp) {
+				// Mismatched; leave it to the parser
+				return;
+			}
+			m_deferred->push_back(DeferredNode{
+				m_defer_count - 1u,
+				m_source_cur, pos,
+				line(), column()
+			});
+			// Continue from the close-brace
+			m_curchar = cp;
+			m_source_cur = cur;
+			m_source_pos = pos;
+			return;
+
+		default:
+			break;
+		}
+		cur = pos;
+		cp = read_source_char(pos);
+		if (CHAR_EOF == cp) {
+			// Unclosed; leave it to the parser
+			return;
+		}
+	}
+}
+
+duct::aux::vector<char const*>
+ScriptParser::split_source(
+	char const* const begin,
+	char const* const end,
+	std::size_t const chunk_count
+) {
+	duct::aux::vector<char const*> splits{};
+	splits.reserve(chunk_count + 1u);
+	splits.push_back(begin);
+	std::size_t const step = static_cast<std::size_t>(end - begin) / chunk_count;
+	char const* target = begin + step;
+	ScanState state = ScanState::normal;
+	signed depth = 0;
+	char32 cp;
+	for (char const* pos = begin; end != pos && chunk_count > splits.size();) {
+		char const* const next
+			= UTF8Utils::decode(pos, end, cp, CHAR_SENTINEL);
+		if (next == pos) {
+			break;
+		}
+		pos = next;
+		switch (scan_char(state, cp)) {
+		case ScanEvent::open: ++depth; break;
+		case ScanEvent::close: --depth; break;
+		case ScanEvent::newline:
+			if (0 == depth && target <= pos && end != pos) {
+				splits.push_back(pos);
+				target = pos + step;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	splits.push_back(end);
+	return splits;
+}
+
+ScriptParser::ChunkResult
+ScriptParser::process_chunk(
+	Var& node,
+	char const* const* const splits,
+	std::size_t& count,
+	bool const final
+) noexcept {
+	try {
+		initialize(splits[0u], splits[1u]);
+		m_builder.reset(node);
+		m_handler = &m_builder;
+		push(VarType::node); // Root
+		std::size_t index = 0u;
+		for (;;) {
+			// Stop before EOF so that the state after the chunk's final
+			// newline can be checked
+			for (;;) {
+				skip_whitespace();
+				if (CHAR_EOF == m_curchar) {
+					break;
+				}
+				discern_token();
+				read_token();
+			}
+			if (++index == count) {
+				break;
+			} else if (
+				at_root() &&
+				m_token_ident.is_null() &&
+				0u == m_states.value()
+			) {
+				count = index;
+				reset();
+				return ChunkResult::closed;
+			}
+			continue_source(splits[index], splits[index + 1u]);
+		}
+		if (final) {
+			do {} while (parse());
+			end_process();
+			return ChunkResult::closed;
+		}
+		bool const closed
+			= at_root()
+			&& m_token_ident.is_null()
+			&& 0u == m_states.value()
+		;
+		reset();
+		return closed ? ChunkResult::closed : ChunkResult::open;
+	} catch (...) {
+		reset();
+		return ChunkResult::error;
+	}
+}
+
+bool
+ScriptParser::process_parallel(
+	Var& node,
+	char const* const begin,
+	char const* const end,
+	unsigned thread_count
+) {
+	enum : std::size_t {
+		// Smallest chunk worth a task
+		min_chunk_size = 1u << 16,
+		// Chunks per thread, for balance
+		thread_chunks = 4u
+	};
+	if (begin > end) {
+		return false;
+	}
+	if (0u == thread_count) {
+		thread_count = std::thread::hardware_concurrency();
+	}
+	std::size_t const chunk_count = std::min<std::size_t>(
+		std::size_t{thread_count} * thread_chunks,
+		static_cast<std::size_t>(end - begin) / min_chunk_size
+	);
+	// An arena cannot be shared by the workers
+	if (
+		nullptr != m_arena || nullptr != Arena::current() ||
+		2u > thread_count || 2u > chunk_count
+	) {
+		return process(node, begin, end);
+	}
+	auto const splits = split_source(begin, end, chunk_count);
+	std::size_t const count = splits.size() - 1u;
+	if (2u > count) {
+		return process(node, begin, end);
+	}
+
+	// Process chunks as if each starts in root scope
+	duct::aux::vector<Var> roots(count, Var{VarType::node});
+	duct::aux::vector<ChunkResult> results(count, ChunkResult::error);
+	std::atomic<std::size_t> next{0u};
+	auto const lexer = m_lexer;
+	auto const worker = [&]() {
+		// A worker that fails leaves its chunks as errors, which are
+		// processed again sequentially
+		try {
+			ScriptParser parser{};
+			parser.set_lexer(lexer);
+			for (std::size_t i; count > (i = next++);) {
+				std::size_t one = 1u;
+				results[i] = parser.process_chunk(
+					roots[i], splits.data() + i, one, count - 1u == i
+				);
+			}
+		} catch (...) {}
+	};
+	duct::aux::vector<std::thread> threads{};
+	threads.reserve(thread_count);
+	try {
+		for (unsigned t = 1u; t < thread_count && t < count; ++t) {
+			threads.emplace_back(worker);
+		}
+	} catch (std::system_error&) {
+		// Continue with the threads that started
+	}
+	worker();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	// A chunk's result is only valid if the chunk before it ended in
+	// root scope; otherwise the chunk is processed again, continuing
+	// from its predecessor. An error in a valid chunk is real, and is
+	// reproduced sequentially to report it identically.
+	for (std::size_t i = 0u; count > i;) {
+		if (ChunkResult::error == results[i]) {
+			return process(node, begin, end);
+		} else if (ChunkResult::closed == results[i]) {
+			++i;
+			continue;
+		}
+		std::size_t taken = count - i;
+		roots[i] = Var{VarType::node};
+		if (
+			ChunkResult::error
+			== process_chunk(roots[i], splits.data() + i, taken, true)
+		) {
+			return process(node, begin, end);
+		}
+		for (std::size_t j = 1u; taken > j; ++j) {
+			roots[i + j] = Var{VarType::null};
+		}
+		// The last chunk taken ended in root scope, so the chunk
+		// following it is valid
+		i += taken;
+	}
+	node.morph(VarType::node, false); // Make sure variable is a node
+	for (auto& root : roots) {
+		if (root.is_type(VarType::node)) {
+			for (auto& child : root.children()) {
+				node.children().emplace_back(std::move(child));
+			}
+		}
+	}
+	return true;
+}
+
 bool
 ScriptParser::parse() {
 	//next_char();
@@ -228,7 +916,12 @@ ScriptParser::parse() {
 void
 ScriptParser::discern_token() {
 	m_token.reset(NULL_TOKEN, false);
-	m_token.set_position(m_line, m_column);
+	if (has_source() && nullptr != m_source_cur) {
+		// Resolved on request (see Token::line())
+		m_token.set_source(m_source_cur, this);
+	} else {
+		m_token.set_position(m_line, m_column);
+	}
 	switch (m_curchar) {
 	case CHAR_QUOTE:
 		m_token.set_type(TOK_STRING_QUOTED);
@@ -237,14 +930,14 @@ ScriptParser::discern_token() {
 	case CHAR_DECIMALPOINT:
 		m_token.set_type(TOK_FLOATING);
 		// Add the decimal
-		m_token.buffer().push_back(m_curchar);
+		buffer_current();
 		break;
 
 	case CHAR_PLUS:
 	case CHAR_DASH:
 		m_token.set_type(TOK_INTEGER);
 		// Add sign
-		m_token.buffer().push_back(m_curchar);
+		buffer_current();
 		break;
 
 	// Literals
@@ -299,12 +992,21 @@ ScriptParser::read_token() {
 	//	get_token_name(m_token), m_token.line(), m_token.column());
 	switch (m_token.type()) {
 	case TOK_STRING_QUOTED:
-		read_tok_string_quoted();
+		if (use_table_lexer()) {
+			next_char(); // Skip the initial quote
+			read_tok_table(LS_QUOTED);
+		} else {
+			read_tok_string_quoted();
+		}
 		next_char();
 		break;
 
 	case TOK_STRING:
-		read_tok_string();
+		if (use_table_lexer()) {
+			read_tok_table(LS_STRING);
+		} else {
+			read_tok_string();
+		}
 		break;
 
 	case TOK_INTEGER:
@@ -312,13 +1014,21 @@ ScriptParser::read_token() {
 			// Move out of sign
 			next_char();
 		}
-		read_tok_integer();
+		if (use_table_lexer()) {
+			read_tok_table(LS_INTEGER);
+		} else {
+			read_tok_integer();
+		}
 		break;
 
 	case TOK_FLOATING:
 		// Move out of decimal
 		next_char();
-		read_tok_floating();
+		if (use_table_lexer()) {
+			read_tok_table(LS_FLOATING);
+		} else {
+			read_tok_floating();
+		}
 		break;
 
 	// Literals
@@ -481,6 +1191,12 @@ ScriptParser::handle_token() {
 			);
 		} else {
 			make_collection(VarType::node);
+			if (
+				nullptr != m_deferred &&
+				m_defer_depth + 1u == m_stack.size()
+			) {
+				defer_node();
+			}
 		}
 		break;
 
@@ -537,7 +1253,7 @@ ScriptParser::handle_token() {
 		} else if (!in_scope(VarType::array)) {
 			DUCT_SP_THROWF_(
 				"Unexpected close-bracket in %s scope",
-				var_type_name(current_collection().type())
+				var_type_name(current_scope())
 			);
 		} else if (m_states.test(State::equals)) {
 			DUCT_SP_THROW_(
@@ -593,9 +1309,9 @@ ScriptParser::read_tok_integer() {
 			// Single terminators
 			break;
 		} else if (s_set_numeral.contains(m_curchar)) {
-			m_token.buffer().push_back(m_curchar);
+			buffer_current();
 		} else if (CHAR_DECIMALPOINT == m_curchar) {
-			m_token.buffer().push_back(m_curchar);
+			buffer_current();
 			m_token.set_type(TOK_FLOATING);
 			next_char();
 			read_tok_floating();
@@ -627,7 +1343,7 @@ ScriptParser::read_tok_floating() {
 			// Single terminators
 			break;
 		} else if (s_set_numeral.contains(m_curchar)) {
-			m_token.buffer().push_back(m_curchar);
+			buffer_current();
 		} else {
 			m_token.set_type(TOK_STRING);
 			read_tok_string();
@@ -665,7 +1381,7 @@ ScriptParser::read_tok_literal(
 			read_tok_string();
 			return;
 		} else { // Haven't overrun and char matches current
-			m_token.buffer().push_back(m_curchar);
+			buffer_current();
 			++index;
 		}
 		next_char();
@@ -697,16 +1413,20 @@ ScriptParser::read_tok_string() {
 		) {
 			break;
 		} else {
-			m_token.buffer().push_back(m_curchar);
+			buffer_current();
 		}
 		next_char();
 	}
 }
 
 void
-ScriptParser::read_tok_string_quoted() {
+ScriptParser::read_tok_string_quoted(
+	bool const resume
+) {
 	bool eol_reached = false;
-	next_char(); // Skip the first character (it will be the initial quote)
+	if (!resume) {
+		next_char(); // Skip the first character (it will be the initial quote)
+	}
 	while (CHAR_QUOTE != m_curchar) {
 		if (CHAR_EOF == m_curchar) {
 			DUCT_SP_THROW_("Encountered EOF whilst reading quoted string");
@@ -723,19 +1443,83 @@ ScriptParser::read_tok_string_quoted() {
 			}
 		} else {
 			if (!eol_reached) {
-				m_token.buffer().push_back(m_curchar);
+				buffer_current();
 			}
 			if (CHAR_NEWLINE == m_curchar) {
 				eol_reached = true;
 			} else if (eol_reached && !s_set_whitespace.contains(m_curchar)) {
 				eol_reached = false;
-				m_token.buffer().push_back(m_curchar);
+				buffer_current();
 			}
 		}
 		next_char();
 	}
 }
 
+void
+ScriptParser::read_tok_table(
+	unsigned state
+) {
+	for (;;) {
+		std::uint8_t const cls
+			= (0x80 > m_curchar)
+			? s_lex_class[m_curchar]
+			: (CHAR_EOF == m_curchar) ? std::uint8_t{LC_E} : std::uint8_t{LC_H}
+		;
+		std::uint8_t transition = s_lex_transition[state][cls];
+		switch (transition & LA_MASK) {
+		case LA_CONTINUE: {
+			buffer_current();
+			state = transition & ~LA_MASK;
+			// Consume the following run of plain bytes
+			char const* pos = m_source_pos;
+			for (; m_source_end != pos; ++pos) {
+				transition = s_lex_transition[state][
+					s_lex_class[static_cast<char8_strict>(*pos)]
+				];
+				if (LA_CONTINUE != (transition & LA_MASK)) {
+					break;
+				}
+				state = transition & ~LA_MASK;
+			}
+			if (m_source_pos != pos) {
+				m_token.buffer().push_back(m_source_pos, pos);
+				m_source_pos = pos;
+			}
+			next_char();
+		}	break;
+
+		case LA_END:
+			m_token.set_type(s_lex_token_type[state]);
+			return;
+
+		case LA_SLASH:
+			if (CHAR_SLASH == peek_char() || CHAR_ASTERISK == m_peekchar) {
+				// Comment or comment block terminate
+				m_token.set_type(s_lex_token_type[state]);
+				return;
+			}
+			// fall-through
+
+		case LA_PLAIN:
+			buffer_current();
+			state = transition & ~LA_MASK;
+			next_char();
+			break;
+
+		case LA_DELEGATE:
+			m_token.set_type(s_lex_token_type[state]);
+			switch (state) {
+			case LS_STRING: read_tok_string(); break;
+			case LS_INTEGER: read_tok_integer(); break;
+			case LS_FLOATING: read_tok_floating(); break;
+			case LS_QUOTED: read_tok_string_quoted(true); break;
+			}
+			return;
+		}
+	}
+}
+
 void
 ScriptParser::read_tok_comment_block() {
 	next_char(); // Skip the first character (it will be an asterisk)
@@ -761,47 +1545,36 @@ ScriptParser::at_root() const noexcept {
 	return 1 >= m_stack.size();
 }
 
-Var&
-ScriptParser::current_collection() noexcept {
+VarType
+ScriptParser::current_scope() const noexcept {
 	DUCT_DEBUG_ASSERT(
 		0 < m_stack.size(),
 		"Something has gone horribly wrong: stack is empty!"
 	);
-	DUCT_DEBUG_ASSERT(
-		nullptr != m_stack.back(),
-		"Something has gone horribly wrong: stack.back() is null!"
-	);
-	return *(m_stack.back());
+	return m_stack.back();
 }
 
 void
 ScriptParser::push(
-	Var& collection
+	VarType const type
 ) {
 	DUCT_DEBUG_ASSERT(
-		collection.is_type_of(VarMask::collection),
+		var_type_is_of(type, VarMask::collection),
 		"Something has gone horribly wrong:"
 		" cannot push a non-collection"
 	);
 	DUCT_DEBUG_ASSERT(
 		0 == m_stack.size() ||
-		!collection.is_type(VarType::node) ||
+		VarType::node != type ||
 		!in_scope(VarType::identifier),
 		"Something has gone horribly wrong:"
 		" cannot push a node whilst in identifier scope"
 	);
 	//DUCT_DEBUGF("at %lu, pushing %s",
 	//	static_cast<unsigned long>(m_stack.size()),
-	//	var_type_name(collection.type())
+	//	var_type_name(type)
 	//);
-	if (0 < m_stack.size()) {
-		DUCT_DEBUG_ASSERT(
-			(&collection) != m_stack.back(),
-			"Something has gone horribly wrong:"
-			" pushing same collection"
-		);
-	}
-	m_stack.push_back(&collection);
+	m_stack.push_back(type);
 }
 
 void
@@ -811,9 +1584,34 @@ ScriptParser::pop() {
 		"Something has gone horribly wrong:"
 		" the root node cannot be popped"
 	);
+	end_collection(m_stack.back());
 	m_stack.pop_back();
 }
 
+void
+ScriptParser::begin_collection(
+	VarType const type,
+	CharBuf const& name
+) {
+	count_child();
+	switch (type) {
+	case VarType::node: m_handler->on_node_begin(name); break;
+	case VarType::identifier: m_handler->on_identifier_begin(name); break;
+	default: m_handler->on_array_begin(name); break;
+	}
+}
+
+void
+ScriptParser::end_collection(
+	VarType const type
+) {
+	switch (type) {
+	case VarType::node: m_handler->on_node_end(); break;
+	case VarType::identifier: m_handler->on_identifier_end(); break;
+	default: m_handler->on_array_end(); break;
+	}
+}
+
 void
 ScriptParser::throwex(
 	ScriptParserException&& e
@@ -834,7 +1632,9 @@ ScriptParser::make_ident() {
 		"Something has gone horribly wrong:"
 		" should not have State::equals here"
 	);
-	m_token_ident = m_token;
+	// The token is reset when the next one is discerned, so its buffer
+	// can be taken instead of copied
+	std::swap(m_token_ident, m_token);
 	m_states.remove(State::comma | State::open_array);
 }
 
@@ -856,7 +1656,7 @@ ScriptParser::make_collection(
 			"Something has gone horribly wrong:"
 			" cannot make a nameless identifier"
 		);
-		current_collection().emplace_back(type);
+		begin_collection(type, s_nameless);
 		m_states.remove(State::comma | State::open_array);
 	} else { // Named collection
 		DUCT_DEBUG_ASSERT(
@@ -865,16 +1665,14 @@ ScriptParser::make_collection(
 			"Something has gone horribly wrong:"
 			" cannot have equality sign when making an identifier"
 		);
-		current_collection().emplace_back(
-			m_token_ident.buffer()
-				.to_string<detail::var_config::name_type>(),
-			type
-		);
+		begin_collection(type, m_token_ident.buffer());
 		m_states.remove(State::equals | State::comma | State::open_array);
 		m_token_ident.reset(NULL_TOKEN, true);
 	}
 	if (push_collection) {
-		push(current_collection().back());
+		push(type);
+	} else {
+		end_collection(type);
 	}
 }
 
@@ -897,38 +1695,11 @@ ScriptParser::make_value() {
 		" should not have State::comma here"
 	);
 
-	auto& coll = current_collection();
-	switch (m_token.type()) {
-	case TOK_STRING:
-	case TOK_STRING_QUOTED:
-		coll.emplace_back(
-			m_token.buffer().to_string<detail::var_config::string_type>()
-		); break;
-
-	case TOK_INTEGER:
-		coll.emplace_back(
-			m_token.buffer().to_arithmetic<detail::var_config::integer_type>()
-		); break;
-
-	case TOK_FLOATING:
-		coll.emplace_back(
-			m_token.buffer().to_arithmetic<detail::var_config::decimal_type>()
-		); break;
-
-	case TOK_LITERAL_TRUE:
-		coll.emplace_back(true);
-		break;
-
-	case TOK_LITERAL_FALSE:
-		coll.emplace_back(false);
-		break;
-
-	case TOK_LITERAL_NULL:
-		coll.emplace_back(VarType::null);
-		break;
-	}
-	coll.back().set_name(
-		m_token_ident.buffer().to_string<detail::var_config::name_type>()
+	count_child();
+	m_handler->on_value(
+		m_token_ident.buffer(),
+		get_token_value_type(m_token.type()),
+		m_token.buffer()
 	);
 	m_states.remove(State::equals);
 	m_token_ident.reset(NULL_TOKEN, true);
@@ -958,36 +1729,12 @@ ScriptParser::make_nameless_value(
 	if (NULL_TOKEN == override_type) {
 		override_type = token.type();
 	}
-	auto& coll = current_collection();
-	switch (override_type) {
-	case TOK_STRING:
-	case TOK_STRING_QUOTED:
-		coll.emplace_back(
-			token.buffer().to_string<detail::var_config::string_type>()
-		); break;
-
-	case TOK_INTEGER:
-		coll.emplace_back(
-			token.buffer().to_arithmetic<detail::var_config::integer_type>()
-		); break;
-
-	case TOK_FLOATING:
-		coll.emplace_back(
-			token.buffer().to_arithmetic<detail::var_config::decimal_type>()
-		); break;
-
-	case TOK_LITERAL_TRUE:
-		coll.emplace_back(true);
-		break;
-
-	case TOK_LITERAL_FALSE:
-		coll.emplace_back(false);
-		break;
-
-	case TOK_LITERAL_NULL:
-		coll.emplace_back(VarType::null);
-		break;
-	}
+	count_child();
+	m_handler->on_value(
+		s_nameless,
+		get_token_value_type(override_type),
+		token.buffer()
+	);
 	if (!m_token_ident.is_null()) {
 		m_token_ident.reset(NULL_TOKEN, true);
 	}
@@ -6,7 +6,8 @@
 
 namespace {
 static CharacterSet const
-	s_set_number_inner{"0-9."},
+	s_set_number_inner{"0-9."};
+static CompiledCharacterSet const
 	s_set_number_front{"0-9.\\-+"},
 	s_set_req_quotation{"\n\t ,=[]{}\"\'"};
 static char const
@@ -115,7 +116,7 @@ ScriptWriter::write_value(
 	bool const with_name
 ) const {
 	if (with_name) {
-		write_string(dest, var.name(), true);
+		write_string<u8string>(dest, var.name(), true);
 		m_stream_ctx.write_char(dest, CHAR_EQUALSIGN);
 	}
 	switch (var.type()) {
@@ -146,7 +147,7 @@ ScriptWriter::write_array(
 	bool const with_name
 ) const {
 	if (with_name && !var.name().empty()) {
-		write_string(dest, var.name(), true);
+		write_string<u8string>(dest, var.name(), true);
 		m_stream_ctx.write_char(dest, CHAR_EQUALSIGN);
 	}
 	m_stream_ctx.write_char(dest, CHAR_OPENBRACKET);
@@ -188,7 +189,7 @@ ScriptWriter::write_node(
 	if (!treat_as_root) {
 		//m_stream_ctx.write_char(dest, CHAR_TAB, tab_level);
 		if (!var.name().empty()) {
-			write_string(dest, var.name(), true);
+			write_string<u8string>(dest, var.name(), true);
 			m_stream_ctx.write_char(dest, CHAR_EQUALSIGN);
 		}
 		m_stream_ctx.write_char(dest, CHAR_OPENBRACE);
@@ -220,7 +221,7 @@ ScriptWriter::write_identifier(
 	std::ostream& dest,
 	Var const& var
 ) const {
-	write_string(dest, var.name(), true);
+	write_string<u8string>(dest, var.name(), true);
 	if (0u < var.size()) {
 		m_stream_ctx.write_char(dest, ' ');
 	}
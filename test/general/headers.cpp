@@ -4,12 +4,18 @@
 #include <duct/traits.hpp>
 #include <duct/char.hpp>
 #include <duct/string.hpp>
+#include <duct/Arena.hpp>
+#include <duct/NamePool.hpp>
 #include <duct/aux.hpp>
+#include <duct/detail/arithmetic.hpp>
+#include <duct/detail/arithmetic_pow10.hpp>
+#include <duct/detail/hash.hpp>
 #include <duct/detail/string_traits.hpp>
 #include <duct/detail/var.hpp>
 #include <duct/CharBuf.hpp>
 #include <duct/CharacterRange.hpp>
 #include <duct/CharacterSet.hpp>
+#include <duct/CompiledCharacterSet.hpp>
 #include <duct/StateStore.hpp>
 #include <duct/cc_unique_ptr.hpp>
 #include <duct/EndianUtils.hpp>
@@ -22,16 +28,29 @@
 #include <duct/IO/memstream.hpp>
 #include <duct/IO/multistream.hpp>
 #include <duct/IO/dynamic_streambuf.hpp>
+#include <duct/IO/MappedFile.hpp>
 #include <duct/VarType.hpp>
 #include <duct/Var.hpp>
 #include <duct/VarUtils.hpp>
+#include <duct/VarPath.hpp>
+#include <duct/FrozenVar.hpp>
 #include <duct/VarTemplate.hpp>
 #include <duct/Args.hpp>
 #include <duct/Parser.hpp>
 #include <duct/ScriptWriter.hpp>
+#include <duct/ScriptBinary.hpp>
+#include <duct/ScriptHandler.hpp>
 #include <duct/ScriptParser.hpp>
+#include <duct/ScriptDocument.hpp>
+#include <duct/ScriptLoader.hpp>
+#include <duct/ScriptCache.hpp>
+#include <duct/ScriptBinding.hpp>
+
+#include <limits>
+#include <algorithm>
 
 signed
 main() {
-	return 0;
+	// Platform headers must not define min() and max() macros
+	return std::min(0, std::numeric_limits<signed>::max());
 }
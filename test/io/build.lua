@@ -4,4 +4,5 @@ make_tests(
 	["string"] = {nil, nil},
 	["multicast"] = {nil, nil},
 	["dynamic_streambuf"] = {nil, nil},
+	["mapped_file"] = {nil, nil},
 })
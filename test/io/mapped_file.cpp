@@ -0,0 +1,51 @@
+
+#include <duct/debug.hpp>
+#include <duct/IO/MappedFile.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <iostream>
+
+static char const
+s_data[]{"name=value\nx = [1, 2, 3]\n"};
+
+signed
+main() {
+	char const* const path = "mapped_file.tmp";
+	std::ofstream stream{path, std::ios_base::binary};
+	stream.write(s_data, sizeof(s_data) - 1u);
+	stream.close();
+
+	duct::IO::MappedFile file{path};
+	DUCT_ASSERTE(file.is_open());
+	DUCT_ASSERTE(sizeof(s_data) - 1u == file.size());
+	DUCT_ASSERTE(0 == std::memcmp(s_data, file.data(), file.size()));
+	std::cout
+		<< "size: " << file.size() << '\n'
+		<< "data: \"" << std::string(file.begin(), file.end()) << "\"\n"
+	;
+
+	// Move ownership
+	duct::IO::MappedFile moved{std::move(file)};
+	DUCT_ASSERTE(!file.is_open() && nullptr == file.data());
+	DUCT_ASSERTE(moved.is_open() && sizeof(s_data) - 1u == moved.size());
+	moved.close();
+	DUCT_ASSERTE(!moved.is_open());
+
+	// Empty file
+	stream.open(path, std::ios_base::binary | std::ios_base::trunc);
+	stream.close();
+	DUCT_ASSERTE(moved.open(path));
+	DUCT_ASSERTE(0u == moved.size() && moved.begin() == moved.end());
+	moved.close();
+
+	// Nonexistent file
+	std::remove(path);
+	DUCT_ASSERTE(!moved.open(path));
+
+	std::cout.flush();
+	return 0;
+}
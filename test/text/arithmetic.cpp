@@ -0,0 +1,195 @@
+
+#include <duct/debug.hpp>
+#include <duct/aux.hpp>
+#include <duct/CharBuf.hpp>
+#include <duct/detail/arithmetic.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+
+using namespace duct;
+
+template<class T>
+bool
+stream_parse(
+	std::string const& str,
+	T& value
+) {
+	aux::istringstream stream(str);
+	stream >> value;
+	if (stream.fail()) {
+		value = T();
+		return false;
+	}
+	return true;
+}
+
+template<class T>
+bool
+buf_parse(
+	std::string const& str,
+	T& value
+) {
+	CharBuf buf;
+	buf.push_back(str.data(), str.data() + str.size());
+	return buf.to_arithmetic(value);
+}
+
+template<class T>
+bool
+same(
+	T const x,
+	T const y
+) {
+	return 0 == std::memcmp(&x, &y, sizeof(T));
+}
+
+template<class T>
+void
+check(
+	std::string const& str
+) {
+	T sv, bv;
+	bool const ss = stream_parse(str, sv);
+	bool const bs = buf_parse(str, bv);
+	if (ss != bs || !same(sv, bv)) {
+		std::cout
+			<< "mismatch for \"" << str << "\": "
+			<< ss << ' ' << sv << " vs " << bs << ' ' << bv
+		<< std::endl;
+		DUCT_ASSERTE(false);
+	}
+}
+
+std::vector<std::string>
+gen_numbers(
+	unsigned const count,
+	bool const decimal
+) {
+	std::mt19937 rng{42u};
+	std::vector<std::string> numbers;
+	numbers.reserve(count);
+	for (unsigned i = 0; i < count; ++i) {
+		std::string str;
+		if (0u == rng() % 4u) {
+			str.push_back((rng() % 2u) ? '-' : '+');
+		}
+		unsigned const digits = 1u + rng() % (decimal ? 24u : 9u);
+		unsigned const point = decimal ? rng() % (digits + 1u) : digits;
+		for (unsigned d = 0; d < digits; ++d) {
+			if (d == point) {
+				str.push_back('.');
+			}
+			str.push_back(static_cast<char>('0' + rng() % 10u));
+		}
+		numbers.push_back(str);
+	}
+	return numbers;
+}
+
+template<class T>
+double
+time_ms(
+	std::vector<std::string> const& numbers,
+	bool (&parse)(std::string const&, T&)
+) {
+	T value{};
+	unsigned count = 0u;
+	auto const start = std::chrono::steady_clock::now();
+	for (auto const& str : numbers) {
+		count += parse(str, value);
+	}
+	auto const end = std::chrono::steady_clock::now();
+	DUCT_ASSERTE(numbers.size() == count);
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+signed
+main() {
+	// Agreement with istringstream
+	for (auto const& str : gen_numbers(20000u, false)) {
+		check<signed>(str);
+		check<std::int64_t>(str);
+		check<float>(str);
+		check<double>(str);
+	}
+	for (auto const& str : gen_numbers(20000u, true)) {
+		check<float>(str);
+		check<double>(str);
+	}
+	for (char const* str : {
+		"0", "-0", "+0", "16777217", "9007199254740993",
+		"123456789012345678901234567890", "2147483647", "-2147483648"
+	}) {
+		check<signed>(str);
+		check<float>(str);
+		check<double>(str);
+	}
+	for (char const* str : {
+		"-0.0", ".5", "5.", "0.1", "3.4028235", "2.2250738585072011",
+		"0.30000000000000001",
+		"0.000000000000000000000000000000000000000000001",
+		"1e23", "7.038531e-26", "2.2250738585072011e-308",
+		"8.988465674311580536566680e307", "1.7976931348623157e308",
+		"123456789012345678901234567890e-20", "4.35679e-310"
+	}) {
+		check<float>(str);
+		check<double>(str);
+	}
+
+	// Correct rounding past the fast paths
+	double dv = 0.0;
+	DUCT_ASSERTE(buf_parse("9007199254740993", dv) && same(9007199254740992.0, dv));
+	std::string above_tie{"9007199254740993."};
+	above_tie.append(900u, '0');
+	above_tie.push_back('1');
+	DUCT_ASSERTE(buf_parse(above_tie, dv) && same(9007199254740994.0, dv));
+	DUCT_ASSERTE(buf_parse("2.4703282292062328e-324", dv));
+	DUCT_ASSERTE(same(std::numeric_limits<double>::denorm_min(), dv));
+	DUCT_ASSERTE(buf_parse("2.4703282292062327e-324", dv) && same(0.0, dv));
+	DUCT_ASSERTE(buf_parse("1.7976931348623158e308", dv));
+	DUCT_ASSERTE(same(std::numeric_limits<double>::max(), dv));
+	DUCT_ASSERTE(!buf_parse("1.7976931348623159e308", dv));
+	float fhv = 0.0f;
+	DUCT_ASSERTE(buf_parse("1.00000005960464477539062500001", fhv));
+	DUCT_ASSERTE(same(1.00000011920928955078125f, fhv));
+
+	// Rejected forms
+	signed iv = 1;
+	DUCT_ASSERTE(!buf_parse("", iv) && 0 == iv);
+	DUCT_ASSERTE(!buf_parse("-", iv) && 0 == iv);
+	DUCT_ASSERTE(!buf_parse("12a", iv) && 0 == iv);
+	DUCT_ASSERTE(!buf_parse("1.5", iv) && 0 == iv);
+	float fv = 1.0f;
+	DUCT_ASSERTE(!buf_parse("-.", fv) && same(0.0f, fv));
+	DUCT_ASSERTE(buf_parse("1e3", fv) && same(1000.0f, fv));
+	unsigned uv = 1u;
+	DUCT_ASSERTE(!buf_parse("-1", uv) && 0u == uv);
+
+	// Overflow
+	DUCT_ASSERTE(!buf_parse("2147483648", iv) && 0 == iv);
+	DUCT_ASSERTE(!buf_parse("-2147483649", iv) && 0 == iv);
+	DUCT_ASSERTE(buf_parse("-2147483648", iv));
+	DUCT_ASSERTE(std::numeric_limits<signed>::min() == iv);
+	DUCT_ASSERTE(!buf_parse("1e39", fv) && same(0.0f, fv));
+	DUCT_ASSERTE(buf_parse("1e-50", fv) && same(0.0f, fv));
+
+	// Benchmark
+	auto const integers = gen_numbers(200000u, false);
+	auto const decimals = gen_numbers(200000u, true);
+	std::cout
+		<< "integer: stream " << time_ms<signed>(integers, stream_parse)
+		<< " ms, direct " << time_ms<signed>(integers, buf_parse)
+		<< " ms\n"
+		<< "decimal: stream " << time_ms<float>(decimals, stream_parse)
+		<< " ms, direct " << time_ms<float>(decimals, buf_parse)
+		<< " ms\n"
+	;
+	return 0;
+}
@@ -3,5 +3,6 @@ make_tests(
 	"text", {
 	["charset"] = {nil, nil},
 	["charbuf"] = {nil, nil},
+	["arithmetic"] = {nil, nil},
 	["escape"] = {nil, nil},
 })
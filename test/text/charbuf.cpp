@@ -1,4 +1,5 @@
 
+#include <duct/debug.hpp>
 #include <duct/char.hpp>
 #include <duct/string.hpp>
 #include <duct/CharBuf.hpp>
@@ -32,5 +33,36 @@ main() {
 	std::wcout
 		<< L"wide: \"" << wstr << L"\""
 	<< std::endl;
+
+	// Slices
+	char const data[] = "ab\xE3\x81\x82" "c";
+	buf.reset();
+	buf.push_back(data, data + 2);
+	buf.push_back(data + 2, data + 5);
+	DUCT_ASSERTE(buf.is_slice());
+	DUCT_ASSERTE(3u == buf.size());
+	DUCT_ASSERTE("ab\xE3\x81\x82" == buf.to_string());
+
+	// Non-contiguous append converts the slice
+	buf.push_back(data, data + 1);
+	DUCT_ASSERTE(!buf.is_slice());
+	DUCT_ASSERTE(4u == buf.size());
+	DUCT_ASSERTE("ab\xE3\x81\x82" "a" == buf.to_string());
+	buf.push_back('c');
+	DUCT_ASSERTE("ab\xE3\x81\x82" "ac" == buf.to_string());
+
+	// Incomplete sequences
+	buf.reset();
+	buf.push_back(data, data + 4);
+	DUCT_ASSERTE(3u == buf.size());
+	DUCT_ASSERTE(!buf.compare('a'));
+	buf.push_back(data + 4, data + 6);
+	DUCT_ASSERTE(4u == buf.size());
+	DUCT_ASSERTE("ab\xE3\x81\x82" "c" == buf.to_string());
+	buf.reset();
+	buf.push_back(data, data + 4);
+	buf.detach();
+	DUCT_ASSERTE(3u == buf.size());
+	DUCT_ASSERTE(duct::CHAR_REPLACEMENT == buf.to_string<std::u32string>().back());
 	return 0;
 }
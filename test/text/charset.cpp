@@ -1,10 +1,24 @@
 
+#include <duct/debug.hpp>
 #include <duct/char.hpp>
 #include <duct/CharacterSet.hpp>
+#include <duct/CompiledCharacterSet.hpp>
 
+#include <random>
 #include <iostream>
 #include <iomanip>
 
+static constexpr duct::ASCIICharacterSet
+	s_set_terminator{"\n\t ,=[]{}"},
+	s_set_numeral{"0-9"},
+	s_set_sign{"\\-+"}
+;
+
+static_assert(
+	s_set_terminator.contains('{') && !s_set_terminator.contains('a'),
+	"constexpr set is broken"
+);
+
 void
 test(
 	duct::CharacterSet const& cs,
@@ -27,5 +41,44 @@ main() {
 	test(cs, 'Z');
 	std::cout.flush();
 
+	// Compiled sets must agree with their source sets
+	std::mt19937 rng{42u};
+	for (unsigned i = 0; i < 200u; ++i) {
+		duct::CharacterSet source;
+		for (unsigned r = 0; r < 1u + rng() % 8u; ++r) {
+			duct::char32 const first = rng() % ((rng() % 2u) ? 0x100u : 0x3000u);
+			source.add_range(first, rng() % ((rng() % 2u) ? 4u : 0x200u));
+		}
+		duct::CompiledCharacterSet const compiled{source};
+		for (duct::char32 cp = 0; cp < 0x3400u; ++cp) {
+			DUCT_ASSERTE(source.contains(cp) == compiled.contains(cp));
+		}
+	}
+
+	duct::CompiledCharacterSet const compiled{"a-c\\-x-zb-d"};
+	DUCT_ASSERTE(3u == compiled.size());
+	DUCT_ASSERTE(compiled.contains('d') && !compiled.contains('e'));
+	duct::u8string const str{"abx-"};
+	DUCT_ASSERTE(compiled.matches(str, str.cbegin()));
+
+	// ASCII sets must agree with CharacterSet on string ranges
+	for (char const* const ranges : {
+		"a-", "--", "-a", "a-b-", "a\\-", "a-\\-", "\\--a",
+		"a-\\", "\\", "z-a", "a-c\\-x-zb-d", "-", ""
+	}) {
+		duct::ASCIICharacterSet const ascii{ranges};
+		duct::CharacterSet const source{ranges};
+		for (duct::char32 cp = 0; cp < 0x80u; ++cp) {
+			DUCT_ASSERTE(source.contains(cp) == ascii.contains(cp));
+		}
+	}
+	DUCT_ASSERTE(!duct::ASCIICharacterSet{"a-"}.contains('-'));
+
+	DUCT_ASSERTE(s_set_numeral.contains('0') && s_set_numeral.contains('9'));
+	DUCT_ASSERTE(!s_set_numeral.contains('/') && !s_set_numeral.contains(':'));
+	DUCT_ASSERTE(s_set_sign.contains('-') && s_set_sign.contains('+'));
+	DUCT_ASSERTE(!s_set_sign.contains('\\'));
+	DUCT_ASSERTE(s_set_terminator.contains('\n'));
+	DUCT_ASSERTE(!s_set_terminator.contains(0x10000u + '{'));
 	return 0;
 }
@@ -0,0 +1,128 @@
+
+#define DUCT_CONFIG_ALLOCATOR duct::ArenaAllocator
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Arena.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptParser.hpp>
+
+#include <string>
+#include <chrono>
+#include <iostream>
+
+static std::string
+make_document(
+	unsigned const count
+) {
+	std::string doc;
+	for (unsigned i = 0; i < count; ++i) {
+		doc += "entry_" + std::to_string(i) + "={\n"
+			"\tname=\"a long enough string to not be inlined\"\n"
+			"\tvalues=[1, 2.5, true, null, x]\n"
+			"\tident with children\n"
+			"}\n"
+		;
+	}
+	return doc;
+}
+
+static double
+ms_since(
+	std::chrono::steady_clock::time_point const start
+) {
+	return std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+}
+
+signed
+main() {
+	std::string const doc = make_document(20000u);
+	char const* const begin = doc.data();
+	char const* const end = begin + doc.size();
+	duct::ScriptParser parser{};
+
+	// Allocator basics
+	{
+		duct::Arena arena{64u};
+		void* const a = arena.allocate(3u, 1u);
+		void* const b = arena.allocate(8u, 8u);
+		DUCT_ASSERTE(0u == (reinterpret_cast<std::uintptr_t>(b) & 7u));
+		DUCT_ASSERTE(static_cast<char*>(a) + 3u <= static_cast<char*>(b));
+		arena.allocate(1000u);
+		DUCT_ASSERTE(1064u <= arena.capacity());
+		DUCT_ASSERTE(nullptr == duct::Arena::current());
+		{
+			duct::Arena::Scope const scope{&arena};
+			DUCT_ASSERTE(&arena == duct::Arena::current());
+			DUCT_ASSERTE(&arena == duct::u8string{}.get_allocator().arena());
+		}
+		DUCT_ASSERTE(nullptr == duct::Arena::current());
+		arena.release();
+		DUCT_ASSERTE(0u == arena.capacity());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	duct::Var* heap_root = new duct::Var{duct::VarType::node};
+	DUCT_ASSERTE(parser.process(*heap_root, begin, end));
+	double const heap_parse = ms_since(start);
+
+	duct::Arena arena{};
+	parser.set_arena(&arena);
+	start = std::chrono::steady_clock::now();
+	duct::Var* arena_root = new duct::Var{duct::VarType::node};
+	DUCT_ASSERTE(parser.process(*arena_root, begin, end));
+	double const arena_parse = ms_since(start);
+	parser.set_arena(nullptr);
+	DUCT_ASSERTE(nullptr == duct::Arena::current());
+
+	// Same tree; everything below the root is in the arena
+	DUCT_ASSERTE(heap_root->equals(*arena_root));
+	duct::Var const& entry = arena_root->children().back();
+	DUCT_ASSERTE(&arena == entry.name().get_allocator().arena());
+	DUCT_ASSERTE(&arena == entry.children().get_allocator().arena());
+	DUCT_ASSERTE(
+		&arena == entry.children().front().string_ref().get_allocator().arena()
+	);
+	DUCT_ASSERTE(
+		nullptr == heap_root->children().back().name().get_allocator().arena()
+	);
+	DUCT_ASSERTE(0u != arena.capacity());
+
+	// Copies made outside of the arena use the heap
+	duct::Var const copy = entry;
+	DUCT_ASSERTE(copy.equals(entry));
+	DUCT_ASSERTE(nullptr == copy.name().get_allocator().arena());
+	DUCT_ASSERTE(nullptr == copy.children().get_allocator().arena());
+
+	// Parallel processing in the current arena is done sequentially
+	{
+		duct::Arena scoped{};
+		duct::Var* const parallel_root = new duct::Var{duct::VarType::node};
+		{
+			duct::Arena::Scope const scope{&scoped};
+			DUCT_ASSERTE(parser.process_parallel(*parallel_root, begin, end, 4u));
+		}
+		DUCT_ASSERTE(heap_root->equals(*parallel_root));
+		for (auto const& child : parallel_root->children()) {
+			DUCT_ASSERTE(&scoped == child.name().get_allocator().arena());
+		}
+		delete parallel_root;
+	}
+
+	start = std::chrono::steady_clock::now();
+	delete heap_root;
+	double const heap_free = ms_since(start);
+	start = std::chrono::steady_clock::now();
+	delete arena_root;
+	arena.release();
+	double const arena_free = ms_since(start);
+
+	std::cout
+		<< "heap: parse " << heap_parse << " ms, free " << heap_free << " ms\n"
+		<< "arena: parse " << arena_parse << " ms, free " << arena_free << " ms\n"
+	;
+	return 0;
+}
@@ -0,0 +1,149 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/EndianUtils.hpp>
+#include <duct/IO/StreamContext.hpp>
+#include <duct/IO/memstream.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/ScriptBinary.hpp>
+
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <iostream>
+
+static char const
+s_data[] =
+	"name=value int=1234567890 neg=-42 zero=0 dec=0.42 t=true f=false n=null\n"
+	"\"\"=\"\" quoted=\"a string that repeats\" again=\"a string that repeats\"\n"
+	"ident -42 f=89.0001 b=true false n=null a=[1, 2] last\n"
+	"arrays=[[], [1, [2, \"value\"]], 3.5, null]\n"
+	"node={\n"
+	"\tname=value\n"
+	"\tnode={int=-2147483648 value=name}\n"
+	"\t{}\n"
+	"}\n"
+	"\xc3\xa9t\xc3\xa9=\"\xe3\x81\x82\"\n"
+;
+
+static std::string
+write_binary(
+	duct::Var const& var,
+	duct::Endian const endian
+) {
+	duct::BinaryWriter writer{{duct::Encoding::UTF8, endian}};
+	std::ostringstream stream{};
+	DUCT_ASSERTE(writer.write(stream, var));
+	return stream.str();
+}
+
+// Header for a little-endian file with double decimals
+static std::string
+make_header(
+	std::uint32_t const string_size,
+	std::uint32_t const tree_size
+) {
+	std::string data{"DBIN\x01\x00\x08\x00", 8u};
+	for (std::uint32_t const value : {0u, 0u, string_size, tree_size}) {
+		for (unsigned shift = 0u; 32u > shift; shift += 8u) {
+			data += static_cast<char>((value >> shift) & 0xFFu);
+		}
+	}
+	return data;
+}
+
+// Arrays nested depth times around a null
+static std::string
+make_nested(
+	std::size_t const depth
+) {
+	std::string tree{};
+	for (std::size_t i = 0u; depth > i; ++i) {
+		tree.append("\x06\x00\x01", 3u);
+	}
+	tree.append("\x00\x00", 2u);
+	return make_header(0u, static_cast<std::uint32_t>(tree.size())) + tree;
+}
+
+static bool
+read_binary(
+	std::string const& data,
+	duct::Var& var
+) {
+	duct::BinaryReader reader{};
+	duct::IO::imemstream stream{data.data(), data.size()};
+	return reader.read(stream, var);
+}
+
+signed
+main() {
+	duct::ScriptParser parser{};
+	duct::Var root{};
+	DUCT_ASSERTE(parser.process(root, s_data, s_data + std::strlen(s_data)));
+
+	// Round-trips exactly with either endian
+	std::string const little = write_binary(root, duct::Endian::little);
+	std::string const big = write_binary(root, duct::Endian::big);
+	DUCT_ASSERTE(little != big && little.size() == big.size());
+	for (auto const* data : {&little, &big}) {
+		duct::Var read{};
+		DUCT_ASSERTE(read_binary(*data, read));
+		DUCT_ASSERTE(read.equals(root));
+	}
+	std::cout
+		<< "text: " << std::strlen(s_data) << " bytes, "
+		<< "binary: " << little.size() << " bytes\n"
+	;
+
+	// Names and string values are stored once
+	std::size_t count = 0u;
+	for (
+		auto pos = little.find("a string that repeats");
+		std::string::npos != pos;
+		pos = little.find("a string that repeats", pos + 1u)
+	) {
+		++count;
+	}
+	DUCT_ASSERTE(1u == count);
+
+	// Any variable type can be the root
+	duct::Var const value{"x", duct::detail::var_config::integer_type{7}};
+	duct::Var read{};
+	DUCT_ASSERTE(read_binary(write_binary(value, duct::Endian::system), read));
+	DUCT_ASSERTE(read.equals(value));
+
+	// Invalid data fails without touching the output
+	duct::Var untouched{duct::VarType::node};
+	DUCT_ASSERTE(!read_binary("", untouched));
+	DUCT_ASSERTE(!read_binary("DBOX", untouched));
+	for (std::size_t size = 0u; little.size() > size; ++size) {
+		DUCT_ASSERTE(!read_binary(little.substr(0u, size), untouched));
+	}
+	std::string corrupt = little;
+	corrupt[4u] = 2u; // Version
+	DUCT_ASSERTE(!read_binary(corrupt, untouched));
+	corrupt = little;
+	corrupt.back() = static_cast<char>(0xFF); // Unknown type
+	corrupt += '\0';
+	DUCT_ASSERTE(!read_binary(corrupt, untouched));
+
+	// Nesting is limited by the reader
+	duct::BinaryReader reader{};
+	DUCT_ASSERTE(256u == reader.max_depth());
+	DUCT_ASSERTE(read_binary(make_nested(256u), read));
+	DUCT_ASSERTE(read.is_type(duct::VarType::array));
+	DUCT_ASSERTE(!read_binary(make_nested(257u), untouched));
+	DUCT_ASSERTE(!read_binary(make_nested(1000000u), untouched));
+	std::string const nested = make_nested(1000u);
+	duct::IO::imemstream nested_stream{nested.data(), nested.size()};
+	reader.set_max_depth(1000u);
+	DUCT_ASSERTE(reader.read(nested_stream, read));
+
+	// Section sizes larger than the stream fail without allocating them
+	DUCT_ASSERTE(!read_binary(make_header(0xFFFFFFFFu, 0xFFFFFFFFu), untouched));
+	DUCT_ASSERTE(!read_binary(make_header(0u, 0x80000000u) + "\x00", untouched));
+	DUCT_ASSERTE(untouched.is_type(duct::VarType::node) && untouched.empty());
+	return 0;
+}
@@ -4,6 +4,21 @@ make_tests(
 	["value"] = {nil, nil},
 	["collection"] = {nil, nil},
 	["template"] = {nil, nil},
+	["intern"] = {nil, nil},
+	["find"] = {nil, nil},
+	["path"] = {nil, nil},
+	["frozen"] = {nil, nil},
+	["copy_on_write"] = {nil, nil},
+	["diff"] = {nil, nil},
 	["script"] = {nil, nil},
+	["script_handler"] = {nil, nil},
+	["script_parallel"] = {nil, nil},
+	["script_loader"] = {nil, nil},
+	["script_document"] = {nil, nil},
+	["script_alloc"] = {nil, nil},
+	["script_binding"] = {nil, nil},
+	["binary"] = {nil, nil},
+	["script_cache"] = {nil, nil},
+	["arena"] = {nil, nil},
 	["writer"] = {nil, nil},
 })
@@ -0,0 +1,177 @@
+#define DUCT_CONFIG_VAR_COPY_ON_WRITE 1
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/VarUtils.hpp>
+#include <duct/VarPath.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/ScriptDocument.hpp>
+
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+using duct::Var;
+using duct::VarType;
+
+static char const
+s_data[] =
+	"render={\n"
+	"\tshadows={enabled=true cascades=[4, 16, 64]}\n"
+	"\tlights={count=2}\n"
+	"}\n"
+	"audio={volume=0.5}\n"
+;
+
+static duct::Var const*
+children_of(
+	Var const& var
+) {
+	return var.children().data();
+}
+
+signed
+main() {
+	duct::ScriptParser parser{};
+	Var root{};
+	DUCT_ASSERTE(parser.process(root, s_data, s_data + std::strlen(s_data)));
+	Var const original{root};
+
+	// Copies share collections
+	Var snapshot{root};
+	Var const& csnapshot = snapshot;
+	Var const& croot = root;
+	DUCT_ASSERTE(children_of(croot) == children_of(csnapshot));
+	DUCT_ASSERTE(0 == snapshot.compare(root));
+
+	// Modifying one copies only the path to the modified variable
+	Var const* const audio = &croot.back();
+	Var const* const lights_children = children_of(croot.front().at(1u));
+	root.at(0u).at(0u).find("cascades")->at(2u).assign(128);
+	DUCT_ASSERTE(children_of(croot) != children_of(csnapshot));
+	DUCT_ASSERTE(children_of(croot.back()) == children_of(*audio));
+	DUCT_ASSERTE(children_of(croot.front().at(1u)) == lights_children);
+	DUCT_ASSERTE(children_of(csnapshot.front().at(1u)) == lights_children);
+	DUCT_ASSERTE(128 == croot.front().front().back().back().integer());
+	DUCT_ASSERTE(64 == csnapshot.front().front().back().back().integer());
+	DUCT_ASSERTE(duct::VarUtils::identical(snapshot, original));
+
+	// Every modifying operation detaches
+	Var copy{snapshot};
+	copy.front().emplace_back("fog", false);
+	DUCT_ASSERTE(3u == copy.front().size() && 2u == csnapshot.front().size());
+	copy = snapshot;
+	copy.front().erase(copy.front().cbegin());
+	DUCT_ASSERTE(1u == copy.front().size() && 2u == csnapshot.front().size());
+	copy = snapshot;
+	copy.front().reset();
+	DUCT_ASSERTE(copy.front().empty() && 2u == csnapshot.front().size());
+	copy = snapshot;
+	copy.front().set_children({});
+	DUCT_ASSERTE(copy.front().empty() && 2u == csnapshot.front().size());
+	copy = snapshot;
+	copy.back().children().clear();
+	DUCT_ASSERTE(copy.back().empty() && 1u == csnapshot.back().size());
+	copy = snapshot;
+	for (auto& child : copy) {
+		child.set_name("renamed");
+	}
+	DUCT_ASSERTE(nullptr != csnapshot.find("render"));
+	DUCT_ASSERTE(duct::VarUtils::identical(snapshot, original));
+	copy = Var{};
+
+	// Paths resolved for modification detach
+	duct::VarPath const path{"render.lights.count"};
+	Var tree{original};
+	Var tree_snapshot{tree};
+	path.resolve(tree)->assign(42);
+	DUCT_ASSERTE(42 == path.resolve(static_cast<Var const&>(tree))->integer());
+	DUCT_ASSERTE(2 == path.resolve(static_cast<Var const&>(tree_snapshot))->integer());
+	duct::VarPath::Cache cache{};
+	tree_snapshot = tree;
+	DUCT_ASSERTE(42 == path.resolve(static_cast<Var const&>(tree), cache)->integer());
+	path.resolve(tree, cache)->assign(43);
+	DUCT_ASSERTE(43 == path.resolve(tree, cache)->integer());
+	DUCT_ASSERTE(43 == path.resolve(static_cast<Var const&>(tree), cache)->integer());
+	DUCT_ASSERTE(42 == path.resolve(static_cast<Var const&>(tree_snapshot))->integer());
+	DUCT_ASSERTE(duct::VarUtils::identical(snapshot, original));
+
+	// Documents keep unloaded nodes through copies of their tree
+	duct::ScriptDocument document{};
+	DUCT_ASSERTE(document.assign(s_data, s_data + std::strlen(s_data)));
+	Var const doc_snapshot{document.root()};
+	Var* const render = document.find("render");
+	DUCT_ASSERTE(nullptr != render && document.is_loaded(*render));
+	DUCT_ASSERTE(2u == render->size() && 3u == document.unloaded_count());
+	DUCT_ASSERTE(doc_snapshot.find("render")->empty());
+	Var const doc_snapshot_loaded{document.root()};
+	Var* const lights = document.find(*document.find("render"), "lights");
+	DUCT_ASSERTE(nullptr != lights && document.is_loaded(*lights));
+	DUCT_ASSERTE(2 == lights->front().integer() && 2u == document.unloaded_count());
+	DUCT_ASSERTE(doc_snapshot_loaded.find("render")->back().empty());
+	DUCT_ASSERTE(document.load_all().equals(original) && 0u == document.unloaded_count());
+
+	// Shared collections are indexed by lookups through any copy
+	Var registry{VarType::node};
+	for (unsigned i = 0u; 64u > i; ++i) {
+		registry.emplace_back(duct::u8string(std::to_string(i).c_str()), static_cast<signed>(i));
+	}
+	Var const shared{registry};
+	DUCT_ASSERTE(42 == shared.find("42")->integer());
+	DUCT_ASSERTE(42 == registry.find("42")->integer());
+
+	// Snapshots read from other threads while the original changes
+	std::string doc{};
+	for (unsigned i = 0u; 20000u > i; ++i) {
+		doc += "entry" + std::to_string(i) + "={count=" + std::to_string(i) + "}\n";
+	}
+	Var large{};
+	DUCT_ASSERTE(parser.process(large, doc.data(), doc.data() + doc.size()));
+	Var const large_snapshot{large};
+	std::vector<std::thread> threads{};
+	for (unsigned i = 0u; 2u > i; ++i) {
+		threads.emplace_back([&large_snapshot]() {
+			Var local{large_snapshot};
+			for (unsigned r = 0u; 4u > r; ++r) {
+				Var const& clocal = local;
+				signed sum = 0;
+				for (auto const& entry : clocal) {
+					sum += entry.front().integer();
+				}
+				DUCT_ASSERTE(199990000 == sum);
+			}
+			local.front().front().assign(-1);
+		});
+	}
+	for (unsigned i = 0u; 100u > i; ++i) {
+		large.at(i).front().assign(0);
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	DUCT_ASSERTE(0 == large.front().front().integer());
+	DUCT_ASSERTE(0 == large_snapshot.front().front().integer());
+	DUCT_ASSERTE(1 == large_snapshot.at(1u).front().integer());
+
+	// Timing
+	auto start = std::chrono::steady_clock::now();
+	std::size_t count = 0u;
+	for (unsigned i = 0u; 1000u > i; ++i) {
+		Var snapshot_copy{large};
+		count += snapshot_copy.size();
+	}
+	double const copy_ms = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+	DUCT_ASSERTE(1000u * large.size() == count);
+	std::cout
+		<< "1000 snapshots of " << large.size() << " entries: "
+		<< copy_ms << " ms\n"
+	;
+	return 0;
+}
@@ -0,0 +1,168 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/VarUtils.hpp>
+#include <duct/ScriptParser.hpp>
+
+#include <cstring>
+#include <random>
+#include <iostream>
+
+using duct::VarUtils::PatchKind;
+
+static duct::ScriptParser g_parser{};
+
+static duct::Var
+parse(
+	char const* const data
+) {
+	duct::Var root{};
+	DUCT_ASSERTE(g_parser.process(root, data, data + std::strlen(data)));
+	return root;
+}
+
+static duct::VarUtils::Patch
+check_diff(
+	duct::Var const& from,
+	duct::Var const& to
+) {
+	auto const patch = duct::VarUtils::diff(from, to);
+	duct::Var patched = from;
+	DUCT_ASSERTE(duct::VarUtils::apply(patched, patch));
+	DUCT_ASSERTE(duct::VarUtils::identical(patched, to));
+	return patch;
+}
+
+// Makes a small random tree
+static void
+generate(
+	std::mt19937& rng,
+	duct::Var& var,
+	unsigned const depth
+) {
+	static char const* const s_names[]{"", "a", "b", "c"};
+	for (unsigned count = rng() % 5u; 0u < count; --count) {
+		duct::detail::var_config::name_type const name{s_names[rng() % 4u]};
+		unsigned const kind = rng() % ((0u < depth) ? 6u : 4u);
+		switch (kind) {
+		case 0u: var.emplace_back(name, duct::detail::var_config::string_type{s_names[rng() % 4u]}); break;
+		case 1u: var.emplace_back(name, static_cast<std::int32_t>(rng() % 3u)); break;
+		case 2u: var.emplace_back(name, 0 == rng() % 2u); break;
+		case 3u: var.emplace_back(name, duct::VarType::null); break;
+		default:
+			var.emplace_back(name, duct::VarType::node);
+			generate(rng, var.back(), depth - 1u);
+			break;
+		}
+	}
+}
+
+signed
+main() {
+	auto const from = parse(
+		"name=value\n"
+		"server={\n"
+		"\thost=localhost port=80\n"
+		"\tlimits={connections=10 timeout=1.5}\n"
+		"\tports=[1, 2, 3]\n"
+		"}\n"
+		"client={name=a}\n"
+		"last=true\n"
+	);
+
+	// Nothing changed
+	DUCT_ASSERTE(check_diff(from, from).empty());
+	DUCT_ASSERTE(duct::VarUtils::hash(from) == duct::VarUtils::hash(parse(
+		"name=value server={host=localhost port=80\n"
+		"limits={connections=10 timeout=1.5} ports=[1, 2, 3]\n"
+		"} client={name=a} last=true"
+	)));
+
+	// A changed value is replaced at its path
+	auto patch = check_diff(from, parse(
+		"name=value\n"
+		"server={\n"
+		"\thost=localhost port=80\n"
+		"\tlimits={connections=20 timeout=1.5}\n"
+		"\tports=[1, 2, 3]\n"
+		"}\n"
+		"client={name=a}\n"
+		"last=true\n"
+	));
+	DUCT_ASSERTE(1u == patch.size() && PatchKind::replace == patch[0u].kind);
+	DUCT_ASSERTE((duct::aux::vector<std::size_t>{1u, 2u, 0u}) == patch[0u].path);
+	DUCT_ASSERTE(20 == patch[0u].value.integer());
+
+	// Inserted and removed children
+	patch = check_diff(from, parse(
+		"name=value\n"
+		"server={\n"
+		"\thost=localhost port=80\n"
+		"\tlimits={connections=10 timeout=1.5}\n"
+		"\tports=[1, 2, 4, 3]\n"
+		"}\n"
+		"last=true\n"
+	));
+	DUCT_ASSERTE(2u == patch.size());
+	DUCT_ASSERTE(PatchKind::insert == patch[0u].kind);
+	DUCT_ASSERTE((duct::aux::vector<std::size_t>{1u, 3u, 2u}) == patch[0u].path);
+	DUCT_ASSERTE(PatchKind::remove == patch[1u].kind);
+	DUCT_ASSERTE((duct::aux::vector<std::size_t>{2u}) == patch[1u].path);
+	patch = check_diff(from, parse(
+		"name=value\n"
+		"server={\n"
+		"\thost=localhost port=80\n"
+		"\tlimits={connections=10 timeout=1.5}\n"
+		"\tports=[1, 2, 3]\n"
+		"}\n"
+		"last=true\n"
+	));
+	DUCT_ASSERTE(1u == patch.size() && PatchKind::remove == patch[0u].kind);
+	DUCT_ASSERTE((duct::aux::vector<std::size_t>{2u}) == patch[0u].path);
+
+	// Renamed or retyped variables are replaced whole
+	patch = check_diff(from, parse("name=value server=null client={name=a} last=true"));
+	DUCT_ASSERTE(1u == patch.size() && PatchKind::replace == patch[0u].kind);
+	patch = check_diff(from, parse("x=1"));
+	check_diff(duct::Var{duct::VarType::node}, from);
+	check_diff(from, duct::Var{duct::VarType::node});
+	check_diff(from, duct::Var{"x", duct::VarType::array});
+
+	// Decimals compare by bit pattern, as they hash
+	duct::Var const zero{"x", duct::detail::var_config::decimal_type{0.0f}};
+	duct::Var const negative_zero{"x", duct::detail::var_config::decimal_type{-0.0f}};
+	DUCT_ASSERTE(!duct::VarUtils::identical(zero, negative_zero));
+	DUCT_ASSERTE(duct::VarUtils::hash(zero) != duct::VarUtils::hash(negative_zero));
+	DUCT_ASSERTE(1u == check_diff(zero, negative_zero).size());
+
+	// Invalid paths fail
+	duct::Var target = from;
+	DUCT_ASSERTE(!duct::VarUtils::apply(target, {
+		{PatchKind::remove, {9u}, duct::Var{}}
+	}));
+	DUCT_ASSERTE(!duct::VarUtils::apply(target, {
+		{PatchKind::insert, {0u, 0u}, duct::Var{}}
+	}));
+	DUCT_ASSERTE(!duct::VarUtils::apply(target, {
+		{PatchKind::remove, {}, duct::Var{}}
+	}));
+	DUCT_ASSERTE(duct::VarUtils::apply(target, {
+		{PatchKind::insert, {from.size()}, duct::Var{"x", duct::VarType::null}}
+	}));
+	DUCT_ASSERTE(from.size() + 1u == target.size());
+
+	// Random trees
+	std::mt19937 rng{42u};
+	for (unsigned i = 0u; 2000u > i; ++i) {
+		duct::Var a{duct::VarType::node};
+		duct::Var b{duct::VarType::node};
+		generate(rng, a, 3u);
+		generate(rng, b, 3u);
+		check_diff(a, b);
+		check_diff(b, a);
+	}
+	std::cout << "ok\n";
+	return 0;
+}
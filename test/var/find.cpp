@@ -0,0 +1,225 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptParser.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+using duct::Var;
+using duct::VarType;
+
+static duct::u8string
+name_of(
+	unsigned const i
+) {
+	return "entry_" + duct::u8string(std::to_string(i).c_str());
+}
+
+static Var const*
+scan(
+	Var const& node,
+	duct::u8string const& name
+) {
+	for (auto const& child : node) {
+		if (child.name() == name) {
+			return &child;
+		}
+	}
+	return nullptr;
+}
+
+static void
+check_all(
+	Var const& node
+) {
+	for (auto const& child : node) {
+		DUCT_ASSERTE(scan(node, child.name()) == node.find(child.name()));
+	}
+	DUCT_ASSERTE(nullptr == node.find("nonexistent"));
+}
+
+signed
+main() {
+	// Linear scan below the threshold
+	Var small{VarType::node};
+	DUCT_ASSERTE(nullptr == small.find("a"));
+	small.emplace_back("a", 1);
+	small.emplace_back("b", 2);
+	small.emplace_back("a", 3);
+	DUCT_ASSERTE(1 == small.find("a")->integer());
+	DUCT_ASSERTE(2u == small.find_all("a").size());
+	DUCT_ASSERTE(3 == small.find_all("a")[1u]->integer());
+	DUCT_ASSERTE(small.find_all("c").empty());
+
+	// Indexed
+	unsigned const count = 4096u;
+	Var node{VarType::node};
+	for (unsigned i = 0u; count > i; ++i) {
+		node.emplace_back(name_of(i), static_cast<signed>(i));
+	}
+	check_all(node);
+
+	// Appends keep the index
+	node.emplace_back(name_of(7u), -7);
+	node.push_back(Var{"appended", true});
+	auto const sevens = node.find_all(name_of(7u));
+	DUCT_ASSERTE(2u == sevens.size());
+	DUCT_ASSERTE(7 == sevens[0u]->integer() && -7 == sevens[1u]->integer());
+	DUCT_ASSERTE(node.find("appended")->boolean());
+	check_all(node);
+
+	// Renames
+	node.at(3u).set_name("renamed");
+	DUCT_ASSERTE(nullptr == node.find(name_of(3u)));
+	DUCT_ASSERTE(3 == node.find("renamed")->integer());
+	node.at(4u) = Var{"assigned", 44};
+	DUCT_ASSERTE(nullptr == node.find(name_of(4u)));
+	DUCT_ASSERTE(44 == node.find("assigned")->integer());
+
+	// Changes through children()
+	std::reverse(node.children().begin(), node.children().end());
+	DUCT_ASSERTE(-7 == node.find(name_of(7u))->integer());
+	node.children().emplace_back("direct", 1);
+	DUCT_ASSERTE(nullptr != node.find("direct"));
+	check_all(node);
+
+	// Changes through a held children() reference
+	{
+		auto& children = node.children();
+		DUCT_ASSERTE(nullptr != node.find(name_of(9u)));
+		children.pop_back();
+		children.emplace_back("held", 2);
+		Var const* const held = node.find("held");
+		DUCT_ASSERTE(nullptr != held && 2 == held->integer());
+		children.back().set_name("held_renamed");
+		DUCT_ASSERTE(nullptr == node.find("held"));
+		node.emplace_back("direct", 1);
+		check_all(node);
+	}
+
+	// Erasure
+	node.erase(node.cend() - 1);
+	DUCT_ASSERTE(nullptr == node.find("direct"));
+	DUCT_ASSERTE(-7 == node.cbegin()[1].integer());
+	node.erase(node.cbegin() + 1);
+	DUCT_ASSERTE(7 == node.find(name_of(7u))->integer());
+	check_all(node);
+
+	// Copies build their own index
+	Var const copy{node};
+	check_all(copy);
+	node.reset();
+	DUCT_ASSERTE(nullptr == node.find(name_of(7u)));
+	DUCT_ASSERTE(nullptr != copy.find(name_of(7u)));
+
+	// Only changed names signal renames
+	auto const generation = Var::name_generation();
+	Var built{VarType::node};
+	char const data[] = "a=1 b=\"two\" c={d=4} e=[5, 6]";
+	DUCT_ASSERTE(duct::ScriptParser{}.process(built, data, data + std::strlen(data)));
+	Var assigned{"a", 2};
+	assigned = built.at(0u);
+	assigned.set_name("a");
+	DUCT_ASSERTE(generation == Var::name_generation());
+	assigned.set_name("b");
+	DUCT_ASSERTE(generation != Var::name_generation());
+
+	// Lookups after renames rebuild the index in place
+	Var renamed{VarType::node};
+	for (unsigned i = 0u; 16u > i; ++i) {
+		renamed.emplace_back(name_of(i), static_cast<signed>(i));
+	}
+	Var const& renamed_view = renamed;
+	for (unsigned i = 0u; 400000u > i; ++i) {
+		renamed.at(0u).set_name(name_of(16u + (i & 1u)));
+		DUCT_ASSERTE(0 == renamed_view.find(name_of(16u + (i & 1u)))->integer());
+	}
+
+	// Concurrent lookups, while unrelated Vars are renamed
+	Var shared{VarType::node};
+	for (unsigned i = 0u; count > i; ++i) {
+		shared.emplace_back(name_of(i), static_cast<signed>(i));
+	}
+	Var const& shared_view = shared;
+	std::atomic<bool> done{false};
+	std::vector<std::thread> readers{};
+	for (unsigned t = 0u; 4u > t; ++t) {
+		readers.emplace_back([&shared_view, &done, count]() {
+			do {
+				for (unsigned i = 0u; count > i; i += 31u) {
+					DUCT_ASSERTE(
+						static_cast<signed>(i) == shared_view.find(name_of(i))->integer()
+					);
+				}
+			} while (!done);
+		});
+	}
+	Var unrelated{};
+	for (unsigned i = 0u; 1000u > i; ++i) {
+		unrelated.set_name(name_of(i));
+	}
+	done = true;
+	for (auto& reader : readers) {
+		reader.join();
+	}
+
+	// Concurrent lookups on a stale index
+	for (unsigned r = 0u; 32u > r; ++r) {
+		shared.at(r).set_name("renamed");
+		readers.clear();
+		for (unsigned t = 0u; 4u > t; ++t) {
+			readers.emplace_back([&shared_view, r, count]() {
+				for (unsigned i = 32u; count > i; i += 31u) {
+					DUCT_ASSERTE(
+						static_cast<signed>(i) == shared_view.find(name_of(i))->integer()
+					);
+				}
+				DUCT_ASSERTE(0 == shared_view.find("renamed")->integer());
+				DUCT_ASSERTE(nullptr == shared_view.find(name_of(r)));
+			});
+		}
+		for (auto& reader : readers) {
+			reader.join();
+		}
+	}
+
+	// Timing
+	Var registry{VarType::node};
+	for (unsigned i = 0u; count > i; ++i) {
+		registry.emplace_back(name_of(i), static_cast<signed>(i));
+	}
+	unsigned const rounds = 16u;
+	auto start = std::chrono::steady_clock::now();
+	std::size_t found = 0u;
+	for (unsigned r = 0u; rounds > r; ++r) {
+		for (unsigned i = 0u; count > i; i += 7u) {
+			found += (nullptr != scan(registry, name_of(i)));
+		}
+	}
+	double const scan_ms = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+	start = std::chrono::steady_clock::now();
+	for (unsigned r = 0u; rounds > r; ++r) {
+		for (unsigned i = 0u; count > i; i += 7u) {
+			found += (nullptr != registry.find(name_of(i)));
+		}
+	}
+	double const find_ms = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+	DUCT_ASSERTE(2u * rounds * ((count + 6u) / 7u) == found);
+	std::cout
+		<< count << " children: scan " << scan_ms << " ms, find "
+		<< find_ms << " ms\n"
+	;
+	return 0;
+}
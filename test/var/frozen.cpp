@@ -0,0 +1,192 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/VarUtils.hpp>
+#include <duct/FrozenVar.hpp>
+#include <duct/ScriptParser.hpp>
+
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+using duct::Var;
+using duct::FrozenVar;
+using duct::VarType;
+
+static char const
+s_data[] =
+	"name=\"example config\"\n"
+	"include=a.script include=b.script\n"
+	"tags sky \"sea\" land\n\n"
+	"server={\n"
+	"\thost=localhost port=8080 secure=true ratio=0.25\n"
+	"\tports=[1, 2, [3, []]]\n"
+	"\tempty={}\n"
+	"\tnothing=null\n"
+	"}\n"
+	"server={host=\"example.com\"}\n"
+;
+
+template<class T>
+static bool
+same(
+	T const x,
+	T const y
+) {
+	return 0 == std::memcmp(&x, &y, sizeof(T));
+}
+
+static void
+check_same(
+	Var const& var,
+	FrozenVar::Ref const frozen
+) {
+	DUCT_ASSERTE(frozen.valid());
+	DUCT_ASSERTE(var.type() == frozen.type());
+	DUCT_ASSERTE(frozen.name() == static_cast<duct::u8string const&>(var.name()));
+	switch (var.type()) {
+	case VarType::string:
+		DUCT_ASSERTE(frozen.string_ref() == var.string_ref());
+		break;
+	case VarType::integer: DUCT_ASSERTE(var.integer() == frozen.integer()); break;
+	case VarType::decimal: DUCT_ASSERTE(same(var.decimal(), frozen.decimal())); break;
+	case VarType::boolean: DUCT_ASSERTE(var.boolean() == frozen.boolean()); break;
+	case VarType::array:
+	case VarType::node:
+	case VarType::identifier: {
+		DUCT_ASSERTE(var.size() == frozen.size());
+		auto it = frozen.begin();
+		for (auto const& child : var) {
+			check_same(child, *it++);
+		}
+		DUCT_ASSERTE(frozen.end() == it);
+	}	break;
+	default:
+		break;
+	}
+}
+
+static std::size_t
+count_nodes(
+	FrozenVar::Ref const ref
+) {
+	std::size_t count = 1u;
+	if (ref.is_type_of(duct::VarMask::collection)) {
+		for (auto const child : ref) {
+			count += count_nodes(child);
+		}
+	}
+	return count;
+}
+
+static std::size_t
+count_nodes(
+	Var const& var
+) {
+	std::size_t count = 1u;
+	if (var.is_type_of(duct::VarMask::collection)) {
+		for (auto const& child : var) {
+			count += count_nodes(child);
+		}
+	}
+	return count;
+}
+
+signed
+main() {
+	duct::ScriptParser parser{};
+	Var root{};
+	DUCT_ASSERTE(parser.process(root, s_data, s_data + std::strlen(s_data)));
+
+	FrozenVar const frozen{root};
+	check_same(root, frozen.root());
+	DUCT_ASSERTE(duct::VarUtils::identical(root, frozen.thaw()));
+	DUCT_ASSERTE(count_nodes(root) == frozen.node_count());
+
+	// Names and strings are stored once
+	DUCT_ASSERTE(frozen.root().at(1u).name().data == frozen.root().at(2u).name().data);
+	DUCT_ASSERTE(
+		frozen.root().at(4u).name().data == frozen.root().at(5u).name().data
+	);
+
+	// Lookup
+	auto const server = frozen.root().find("server");
+	DUCT_ASSERTE(server.valid() && server.is_type(VarType::node));
+	DUCT_ASSERTE(8080 == server.find("port").integer());
+	DUCT_ASSERTE(server.find("secure").boolean());
+	DUCT_ASSERTE(same(duct::detail::var_config::decimal_type{0.25f}, server.find("ratio").decimal()));
+	DUCT_ASSERTE("localhost" == server.find("host").string());
+	DUCT_ASSERTE(server.find("host").string_ref() != "example.com");
+	DUCT_ASSERTE(server.find("empty").empty());
+	DUCT_ASSERTE(server.find("nothing").is_null());
+	DUCT_ASSERTE(!server.find("nonexistent").valid());
+	auto const ports = server.find("ports");
+	DUCT_ASSERTE(3u == ports.size() && 2 == ports.at(1u).integer());
+	DUCT_ASSERTE(ports.back().back().empty());
+	DUCT_ASSERTE(frozen.root().back().front().string_ref() == "example.com");
+	DUCT_ASSERTE(server.find("port") == server.at(1u));
+	DUCT_ASSERTE(server != frozen.root().back());
+
+	// Non-collection roots
+	DUCT_ASSERTE(FrozenVar{}.root().is_null());
+	FrozenVar const integer{Var{"x", 42}};
+	DUCT_ASSERTE(42 == integer.root().integer() && integer.root().name() == "x");
+	Var const string{"s", duct::u8string{"str"}};
+	DUCT_ASSERTE(duct::VarUtils::identical(string, FrozenVar{string}.thaw()));
+
+	// Shared between threads
+	std::string doc{};
+	for (unsigned i = 0u; 20000u > i; ++i) {
+		doc
+			+= "entry" + std::to_string(i)
+			+ "={name=\"value\" count=" + std::to_string(i)
+			+ " flags=[true, false, 0.5]}\n"
+		;
+	}
+	Var large{};
+	DUCT_ASSERTE(parser.process(large, doc.data(), doc.data() + doc.size()));
+	FrozenVar const frozen_large{large};
+	std::size_t const expected = count_nodes(large);
+	std::vector<std::thread> threads{};
+	std::vector<std::size_t> counts(4u, 0u);
+	for (unsigned i = 0u; counts.size() > i; ++i) {
+		threads.emplace_back([&frozen_large, &counts, i]() {
+			counts[i] = count_nodes(frozen_large.root());
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (auto const count : counts) {
+		DUCT_ASSERTE(expected == count);
+	}
+
+	// Timing
+	auto start = std::chrono::steady_clock::now();
+	std::size_t total = 0u;
+	for (unsigned i = 0u; 10u > i; ++i) {
+		total += count_nodes(large);
+	}
+	double const var_ms = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+	start = std::chrono::steady_clock::now();
+	for (unsigned i = 0u; 10u > i; ++i) {
+		total += count_nodes(frozen_large.root());
+	}
+	double const frozen_ms = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+	DUCT_ASSERTE(20u * expected == total);
+	std::cout
+		<< expected << " variables (" << frozen_large.string_size()
+		<< " string bytes): traverse Var " << var_ms << " ms, FrozenVar "
+		<< frozen_ms << " ms\n"
+	;
+	return 0;
+}
@@ -0,0 +1,122 @@
+
+#define DUCT_CONFIG_VAR_INTERN_NAMES 1
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/NamePool.hpp>
+#include <duct/Var.hpp>
+#include <duct/VarTemplate.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/ScriptWriter.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+using duct::u8string;
+using duct::InternedName;
+using duct::NamePool;
+using duct::Var;
+using duct::VarType;
+using duct::VarMask;
+using duct::VarTemplate;
+
+static char const
+s_data[] =
+	"{name=a pos=[1, 2] color=red}\n"
+	"{name=b pos=[3, 4] color=green}\n"
+	"{name=c pos=[5, 6] color=blue}\n"
+	"\"a name that is too long to be stored in place\"=1\n"
+	"\"a name that is too long to be stored in place\"=2\n"
+;
+
+signed
+main() {
+	static_assert(
+		std::is_same<InternedName, duct::detail::var_config::name_type>::value,
+		"names are not interned"
+	);
+
+	// Names
+	InternedName const empty{};
+	DUCT_ASSERTE(empty.empty() && empty == InternedName{""});
+	InternedName const x{"name"};
+	InternedName const y{u8string{"name"}};
+	DUCT_ASSERTE(&x.str() == &y.str() && x == y);
+	DUCT_ASSERTE(x == "name" && x == u8string{"name"});
+	DUCT_ASSERTE(x != "pos" && x != InternedName{"pos"});
+	DUCT_ASSERTE(0 > x.compare("pos") && 0 < InternedName{"pos"}.compare(x));
+
+	// Parsed names share storage
+	duct::ScriptParser parser{};
+	Var root{};
+	DUCT_ASSERTE(parser.process(root, s_data, s_data + std::strlen(s_data)));
+	std::size_t const pooled = NamePool::shared().size();
+	for (unsigned index = 0u; 3u > index; ++index) {
+		auto const& node = root.at(index);
+		DUCT_ASSERTE(node.front().name() == x);
+		DUCT_ASSERTE(&node.front().name().str() == &x.str());
+	}
+	DUCT_ASSERTE(&root.at(3u).name().str() == &root.at(4u).name().str());
+	Var copy{root};
+	DUCT_ASSERTE(copy.equals(root));
+	DUCT_ASSERTE(parser.process(copy, s_data, s_data + std::strlen(s_data)));
+	DUCT_ASSERTE(pooled == NamePool::shared().size());
+
+	// Comparison
+	DUCT_ASSERTE(root.at(0u).compare(root.at(1u)) < 0);
+	Var const same{root.at(3u).name(), 1};
+	DUCT_ASSERTE(0 == root.at(3u).compare(same));
+	DUCT_ASSERTE(0 > root.at(3u).compare(root.at(4u)));
+	Var renamed{root.at(0u)};
+	renamed.set_name("renamed");
+	DUCT_ASSERTE(renamed.name() == "renamed");
+	DUCT_ASSERTE(0 != renamed.compare(root.at(0u)));
+	DUCT_ASSERTE(0 == renamed.compare_value(root.at(0u)));
+
+	// Identity
+	VarTemplate const tpl{
+		VarMask::value,
+		VarTemplate::identity_vector_type{"name", "color"}
+	};
+	DUCT_ASSERTE(tpl.validate(root.at(0u).at(0u)));
+	DUCT_ASSERTE(!tpl.validate(root.at(0u).at(1u)));
+	DUCT_ASSERTE(tpl.validate(root.at(2u).at(2u)));
+
+	// Concurrent interning
+	unsigned const name_count = 5000u;
+	std::size_t const before = NamePool::shared().size();
+	std::vector<std::vector<u8string const*>> interned(4u);
+	std::vector<std::thread> threads{};
+	for (auto& result : interned) {
+		threads.emplace_back([&result, name_count]() {
+			for (unsigned i = 0u; name_count > i; ++i) {
+				std::string const name = "concurrent_" + std::to_string(i);
+				result.push_back(&NamePool::shared().intern(name.data(), name.size()));
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	DUCT_ASSERTE(before + name_count == NamePool::shared().size());
+	for (auto const& result : interned) {
+		DUCT_ASSERTE(result == interned[0u]);
+	}
+	DUCT_ASSERTE(*interned[0u][42u] == "concurrent_42");
+
+	// Writing
+	std::ostringstream stream{};
+	duct::ScriptWriter const writer{};
+	DUCT_ASSERTE(writer.write(stream, root, true, 0u));
+	std::string const text = stream.str();
+	std::cout << text;
+	Var written{};
+	DUCT_ASSERTE(parser.process(written, text.data(), text.data() + text.size()));
+	DUCT_ASSERTE(written.equals(root));
+	return 0;
+}
@@ -0,0 +1,117 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/VarPath.hpp>
+#include <duct/ScriptParser.hpp>
+
+#include <cstring>
+#include <chrono>
+#include <iostream>
+
+using duct::Var;
+using duct::VarPath;
+using duct::VarType;
+
+static char const
+s_data[] =
+	"render={\n"
+	"\tshadows={\n"
+	"\t\tenabled=true\n"
+	"\t\tcascades=[4, 16, 64, [1, 2]]\n"
+	"\t}\n"
+	"\tshadows={enabled=false}\n"
+	"}\n"
+	"list=[[a], [b]]\n"
+;
+
+signed
+main() {
+	duct::ScriptParser parser{};
+	Var root{};
+	DUCT_ASSERTE(parser.process(root, s_data, s_data + std::strlen(s_data)));
+	Var const& croot = root;
+
+	// Parsing
+	DUCT_ASSERTE(VarPath{""}.valid() && VarPath{""}.components().empty());
+	DUCT_ASSERTE(4u == VarPath{"render.shadows.cascades[2]"}.components().size());
+	DUCT_ASSERTE(3u == VarPath{"a[1][2]"}.components().size());
+	DUCT_ASSERTE(VarPath{"[0].name"}.valid());
+	char const* const invalid[]{
+		".", "a.", ".a", "a..b", "a[", "a[]", "a[1", "a[x]", "a[1]b",
+		"[99999999999999999999999]"
+	};
+	for (auto const path : invalid) {
+		VarPath const compiled{path};
+		DUCT_ASSERTE(!compiled.valid() && compiled.components().empty());
+		DUCT_ASSERTE(nullptr == compiled.resolve(croot));
+	}
+
+	// Resolution
+	DUCT_ASSERTE(&croot == VarPath{""}.resolve(croot));
+	Var const* const cascade = VarPath{"render.shadows.cascades[2]"}.resolve(croot);
+	DUCT_ASSERTE(nullptr != cascade && 64 == cascade->integer());
+	DUCT_ASSERTE(2 == VarPath{"render.shadows.cascades[3][1]"}.resolve(croot)->integer());
+	DUCT_ASSERTE(VarPath{"render.shadows.enabled"}.resolve(croot)->boolean());
+	DUCT_ASSERTE(!VarPath{"render[1].enabled"}.resolve(croot)->boolean());
+	DUCT_ASSERTE("b" == VarPath{"list[1][0]"}.resolve(croot)->string_ref());
+	DUCT_ASSERTE(nullptr == VarPath{"render.lights"}.resolve(croot));
+	DUCT_ASSERTE(nullptr == VarPath{"render.shadows.cascades[4]"}.resolve(croot));
+	DUCT_ASSERTE(nullptr == VarPath{"render.shadows.enabled.x"}.resolve(croot));
+	VarPath{"render.shadows.enabled"}.resolve(root)->assign(false);
+	DUCT_ASSERTE(!root.find("render")->find("shadows")->find("enabled")->boolean());
+
+	// Cached resolution
+	VarPath const path{"render.shadows.cascades[2]"};
+	VarPath::Cache cache{};
+	DUCT_ASSERTE(cascade == path.resolve(croot, cache));
+	DUCT_ASSERTE(cascade == path.resolve(croot, cache));
+
+	Var& render = *root.find("render");
+	render.at(0u).set_name("old_shadows");
+	Var const* moved = path.resolve(croot, cache);
+	DUCT_ASSERTE(nullptr == moved);
+	render.at(1u).emplace_back("cascades", VarType::array, Var::initializer_list_type{
+		Var{1}, Var{2}, Var{3}
+	});
+	moved = path.resolve(croot, cache);
+	DUCT_ASSERTE(nullptr != moved && 3 == moved->integer());
+	DUCT_ASSERTE(moved == path.resolve(croot, cache));
+
+	// Replacing a child without a rename is caught by its name
+	render.children().pop_back();
+	render.children().emplace_back("other", VarType::node);
+	DUCT_ASSERTE(nullptr == path.resolve(croot, cache));
+
+	// Another root
+	Var copy{root};
+	render.at(0u).set_name("shadows");
+	DUCT_ASSERTE(cascade == path.resolve(croot, cache));
+	DUCT_ASSERTE(nullptr == path.resolve(copy, cache));
+	DUCT_ASSERTE(cascade == path.resolve(croot, cache));
+
+	// Timing
+	unsigned const rounds = 200000u;
+	std::size_t found = 0u;
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned r = 0u; rounds > r; ++r) {
+		found += (nullptr != path.resolve(croot));
+	}
+	double const resolve_ms = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+	start = std::chrono::steady_clock::now();
+	for (unsigned r = 0u; rounds > r; ++r) {
+		found += (nullptr != path.resolve(croot, cache));
+	}
+	double const cached_ms = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start
+	).count();
+	DUCT_ASSERTE(2u * rounds == found);
+	std::cout
+		<< rounds << " resolutions: " << resolve_ms << " ms, cached "
+		<< cached_ms << " ms\n"
+	;
+	return 0;
+}
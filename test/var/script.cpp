@@ -10,8 +10,11 @@
 #include <duct/ScriptParser.hpp>
 
 #include <cstring>
+#include <algorithm>
+#include <string>
 #include <cstdio>
 #include <iomanip>
+#include <sstream>
 #include <iostream>
 #include <fstream>
 
@@ -88,9 +91,11 @@ g_test_data[]{
 	// Comments
 	TDV("name// asdfasdfadf")
 	TDV("name=/*false*/true/*terminal*/")
+	TDV("a /* b c */ d // e f\ng /*/ h")
 
 	// Escape sequences
 	TDV("all=\\n\\r\\t\\,\\=\\[\\]\\{\\}\\\"\\\'\\\\")
+	TDV("a\\=b=\"c \\\" d\" e")
 
 	// Errors
 	TDN("name=")
@@ -117,6 +122,10 @@ g_test_data[]{
 	TDN("a,")
 	TDN(",")
 
+	// Error positions after newlines and multi-byte code points
+	TDN("a=1\r\n\tb=\"\xc3\xa9\"\r\n\xe3\x81\x82=[1,\n 2 3]")
+	TDN("x=1 // comment\n/* block\n\tcomment */ y=\"\xc3\xa9\xc3\xa9\"\nz==")
+
 	{nullptr, 0, false}
 };
 
@@ -124,7 +133,8 @@ void
 parse_stream(
 	duct::Var& root,
 	std::istream& stream,
-	bool const valid
+	bool const valid,
+	std::string& error
 ) {
 	DUCT_ASSERTE(stream.good());
 	if (valid) {
@@ -137,6 +147,7 @@ parse_stream(
 			<< std::endl;
 			DUCT_ASSERTE(false);
 		} catch (duct::ScriptParserException& e) {
+			error = e.what();
 			std::cout
 				<< e.what()
 				<< "\n\n"
@@ -149,6 +160,37 @@ parse_stream(
 	std::cout << '\n';
 }
 
+void
+parse_source(
+	duct::Var& root,
+	TestData const& td,
+	std::string& error
+) {
+	try {
+		g_parser.process(root, td.data, td.data + td.size);
+	} catch (duct::ScriptParserException& e) {
+		error = e.what();
+	}
+}
+
+void
+parse_feed(
+	duct::Var& root,
+	TestData const& td,
+	std::size_t const chunk_size,
+	std::string& error
+) {
+	try {
+		g_parser.begin_feed(root);
+		for (std::size_t pos = 0; td.size > pos; pos += chunk_size) {
+			g_parser.feed(td.data + pos, std::min(chunk_size, td.size - pos));
+		}
+		g_parser.end_feed();
+	} catch (duct::ScriptParserException& e) {
+		error = e.what();
+	}
+}
+
 void
 do_test(
 	duct::Var& root,
@@ -160,7 +202,62 @@ do_test(
 		static_cast<signed>(td.size),
 		td.data
 	);
-	parse_stream(root, stream, td.valid);
+	std::string stream_error;
+	parse_stream(root, stream, td.valid, stream_error);
+
+	// The source buffer path must agree with the stream path
+	for (auto const lexer : {
+		duct::ScriptParser::Lexer::standard,
+		duct::ScriptParser::Lexer::table
+	}) {
+		g_parser.set_lexer(lexer);
+		duct::Var source_root{duct::VarType::node};
+		std::string source_error;
+		parse_source(source_root, td, source_error);
+		DUCT_ASSERTE(stream_error == source_error);
+		DUCT_ASSERTE(!td.valid || root.equals(source_root));
+
+		// Fed data must agree regardless of where it is split
+		for (std::size_t const chunk_size : {1u, 3u}) {
+			duct::Var feed_root{duct::VarType::node};
+			std::string feed_error;
+			parse_feed(feed_root, td, chunk_size, feed_error);
+			DUCT_ASSERTE(stream_error == feed_error);
+			DUCT_ASSERTE(!td.valid || root.equals(feed_root));
+		}
+	}
+	g_parser.set_lexer(duct::ScriptParser::Lexer::standard);
+
+	// Streams in other encodings must agree with the UTF-8 stream
+	for (auto const encoding : {
+		duct::Encoding::UTF16,
+		duct::Encoding::UTF32
+	}) {
+		for (auto const endian : {
+			duct::Endian::little,
+			duct::Endian::big
+		}) {
+			duct::IO::StreamContext const context{encoding, endian};
+			std::ostringstream encoded{};
+			context.write_string(
+				encoded, std::string{td.data, td.size}
+			);
+			std::string const encoded_data = encoded.str();
+			duct::IO::imemstream encoded_stream{
+				encoded_data.data(), encoded_data.size()
+			};
+			duct::ScriptParser encoded_parser{context};
+			duct::Var encoded_root{duct::VarType::node};
+			std::string encoded_error;
+			try {
+				encoded_parser.process(encoded_root, encoded_stream);
+			} catch (duct::ScriptParserException& e) {
+				encoded_error = e.what();
+			}
+			DUCT_ASSERTE(stream_error == encoded_error);
+			DUCT_ASSERTE(!td.valid || root.equals(encoded_root));
+		}
+	}
 }
 
 signed
@@ -179,8 +276,15 @@ main(
 		) {
 			fs.open(argv[index]);
 			if (fs.is_open()) {
-				parse_stream(root, fs, true);
+				std::string error;
+				root.reset();
+				parse_stream(root, fs, true, error);
 				fs.close();
+
+				// The mapped file must agree with the stream
+				duct::Var mapped_root{duct::VarType::node};
+				DUCT_ASSERTE(g_parser.process_file(mapped_root, argv[index]));
+				DUCT_ASSERTE(root.equals(mapped_root));
 			} else {
 				td.data = argv[index];
 				td.size = std::strlen(td.data);
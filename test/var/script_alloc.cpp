@@ -0,0 +1,200 @@
+
+#include <cstddef>
+#include <memory>
+
+// Counts allocations of every auxiliary container
+static std::size_t g_allocations = 0u;
+
+template<class T>
+struct CountingAllocator
+	: public std::allocator<T>
+{
+	template<class U>
+	struct rebind {
+		using other = CountingAllocator<U>;
+	};
+
+	CountingAllocator() = default;
+
+	template<class U>
+	CountingAllocator(
+		CountingAllocator<U> const&
+	) noexcept
+	{}
+
+	T*
+	allocate(
+		std::size_t const count
+	) {
+		++g_allocations;
+		return std::allocator<T>::allocate(count);
+	}
+};
+
+#define DUCT_CONFIG_ALLOCATOR CountingAllocator
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/CharBuf.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptHandler.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/IO/memstream.hpp>
+
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <iostream>
+
+// Sums the sizes of all names and values
+struct SizeHandler final
+	: public duct::ScriptHandler
+{
+	std::size_t size{0u};
+
+	void
+	on_node_begin(
+		duct::CharBuf const& name
+	) override {
+		size += name.size();
+	}
+
+	void
+	on_identifier_begin(
+		duct::CharBuf const& name
+	) override {
+		size += name.size();
+	}
+
+	void
+	on_array_begin(
+		duct::CharBuf const& name
+	) override {
+		size += name.size();
+	}
+
+	void
+	on_value(
+		duct::CharBuf const& name,
+		duct::VarType const /*type*/,
+		duct::CharBuf const& text
+	) override {
+		size += name.size() + text.size();
+	}
+};
+
+// Builds a tree the same way ScriptVarBuilder does
+static void
+rebuild(
+	duct::Var const& from,
+	duct::Var& to
+) {
+	for (auto const& child : from.children()) {
+		if (child.is_type_of(duct::VarMask::collection)) {
+			to.emplace_back(child.name(), child.type());
+			rebuild(child, to.back());
+		} else {
+			to.emplace_back(child);
+		}
+	}
+}
+
+static char const
+s_data[] =
+	"a_name_that_is_too_long_to_be_stored_in_place=1 b=\"two\" c=3.5\n"
+	"ident x 2 \"a quoted string that is too long to be stored in place\"\n"
+	"\n"
+	"escaped\\=name=\"\\\"quoted\\\"\\n\"\n"
+	"server={\n"
+	"\tport=80 // comment\n"
+	"\tinner={port=8080 list=[1, [], \"s\", true, null]} /* block */\n"
+	"}\n"
+	"{ named_child=null }\n"
+	"\xc3\xa9t\xc3\xa9=\"\xe3\x81\x82\"\n"
+;
+
+signed
+main() {
+	char const* const end = s_data + std::strlen(s_data);
+	duct::ScriptParser parser{};
+	SizeHandler handler{};
+	std::size_t allocations;
+	std::size_t size = 0u;
+
+	for (auto const lexer : {
+		duct::ScriptParser::Lexer::standard,
+		duct::ScriptParser::Lexer::table
+	}) {
+		parser.set_lexer(lexer);
+
+		// Source buffer
+		DUCT_ASSERTE(parser.process(handler, s_data, end));
+		size = handler.size;
+		allocations = g_allocations;
+		for (unsigned i = 0u; 100u > i; ++i) {
+			DUCT_ASSERTE(parser.process(handler, s_data, end));
+		}
+		std::cout
+			<< "source: " << g_allocations - allocations
+			<< " allocations\n"
+		;
+		DUCT_ASSERTE(101u * size == handler.size);
+		DUCT_ASSERTE(allocations == g_allocations);
+
+		// Stream
+		duct::IO::imemstream stream{s_data, sizeof(s_data) - 1u};
+		DUCT_ASSERTE(parser.process(handler, stream));
+		allocations = g_allocations;
+		for (unsigned i = 0u; 100u > i; ++i) {
+			stream.clear();
+			stream.seekg(0);
+			DUCT_ASSERTE(parser.process(handler, stream));
+		}
+		std::cout
+			<< "stream: " << g_allocations - allocations
+			<< " allocations\n"
+		;
+		DUCT_ASSERTE(allocations == g_allocations);
+
+		// Fed data
+		for (unsigned i = 0u; 101u > i; ++i) {
+			if (1u == i) {
+				allocations = g_allocations;
+			}
+			parser.begin_feed(handler);
+			for (char const* pos = s_data; end != pos;) {
+				std::size_t const chunk = std::min<std::size_t>(
+					7u, static_cast<std::size_t>(end - pos)
+				);
+				parser.feed(pos, chunk);
+				pos += chunk;
+			}
+			parser.end_feed();
+		}
+		std::cout
+			<< "feed: " << g_allocations - allocations
+			<< " allocations\n"
+		;
+		DUCT_ASSERTE(allocations == g_allocations);
+		handler.size = 0u;
+	}
+
+	// Only the output allocates when building Vars
+	duct::Var first{};
+	DUCT_ASSERTE(parser.process(first, s_data, end));
+	allocations = g_allocations;
+	duct::Var rebuilt{duct::VarType::node};
+	rebuild(first, rebuilt);
+	std::size_t const output_allocations = g_allocations - allocations;
+	DUCT_ASSERTE(rebuilt.equals(first));
+	for (unsigned i = 0u; 10u > i; ++i) {
+		allocations = g_allocations;
+		duct::Var second{};
+		DUCT_ASSERTE(parser.process(second, s_data, end));
+		DUCT_ASSERTE(second.equals(first));
+		DUCT_ASSERTE(output_allocations == g_allocations - allocations);
+	}
+	std::cout << "Var: " << output_allocations << " allocations\n";
+	return 0;
+}
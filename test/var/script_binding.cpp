@@ -0,0 +1,190 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/VarType.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/ScriptBinding.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using duct::VarType;
+using duct::script_field;
+
+struct Limits {
+	unsigned connections{0u};
+	double timeout{0.0};
+};
+
+struct Server {
+	duct::u8string host{};
+	signed port{0};
+	bool secure{false};
+	std::vector<signed> ports{};
+	std::vector<std::vector<float>> matrix{};
+	Limits limits{};
+};
+
+struct Config {
+	std::string name{};
+	std::vector<duct::u8string> includes{};
+	std::vector<duct::u8string> tags{};
+	std::vector<Server> servers{};
+};
+
+namespace duct {
+
+template<>
+struct ScriptBinding<Limits> {
+	template<class F>
+	static void
+	fields(F&& f) {
+		f(
+			script_field("connections", &Limits::connections, VarType::integer),
+			script_field("timeout", &Limits::timeout, VarType::decimal)
+		);
+	}
+};
+
+template<>
+struct ScriptBinding<Server> {
+	template<class F>
+	static void
+	fields(F&& f) {
+		f(
+			script_field("host", &Server::host, VarType::string),
+			script_field("port", &Server::port, VarType::integer),
+			script_field("secure", &Server::secure, VarType::boolean),
+			script_field("ports", &Server::ports, VarType::array),
+			script_field("matrix", &Server::matrix, VarType::array),
+			script_field("limits", &Server::limits, VarType::node)
+		);
+	}
+};
+
+template<>
+struct ScriptBinding<Config> {
+	template<class F>
+	static void
+	fields(F&& f) {
+		f(
+			script_field("name", &Config::name, VarType::string),
+			script_field("include", &Config::includes, VarType::string),
+			script_field("tags", &Config::tags, VarType::identifier),
+			script_field("server", &Config::servers, VarType::node)
+		);
+	}
+};
+
+} // namespace duct
+
+template<class T>
+static bool
+same(
+	T const x,
+	T const y
+) {
+	return 0 == std::memcmp(&x, &y, sizeof(T));
+}
+
+static char const
+s_data[] =
+	"name=\"example config\"\n"
+	"include=a.script include=b.script\n"
+	"tags sky \"sea\" land\n"
+	"\n"
+	"server={\n"
+	"\thost=localhost port=8080 secure=true\n"
+	"\tports=[1, 2, 3]\n"
+	"\tmatrix=[[1, 0.5], [], [-2]]\n"
+	"\tlimits={connections=10 timeout=1}\n"
+	"}\n"
+	"server={host=\"example.com\" limits={timeout=2.5}}\n"
+;
+
+static duct::ScriptBindingError
+bind_error(
+	char const* const data,
+	bool const ignore_unknown = false
+) {
+	duct::ScriptParser parser{};
+	duct::ScriptBinder binder{};
+	Config config{};
+	binder.reset(config, &parser);
+	binder.set_ignore_unknown(ignore_unknown);
+	try {
+		parser.process(binder, data, data + std::strlen(data));
+	} catch (duct::ScriptBindingException& e) {
+		std::cout << e.what() << '\n';
+		return e.error();
+	}
+	return static_cast<duct::ScriptBindingError>(~0u);
+}
+
+signed
+main() {
+	duct::ScriptParser parser{};
+	duct::ScriptBinder binder{};
+	Config config{};
+	binder.reset(config, &parser);
+	DUCT_ASSERTE(parser.process(binder, s_data, s_data + std::strlen(s_data)));
+
+	DUCT_ASSERTE("example config" == config.name);
+	DUCT_ASSERTE(2u == config.includes.size());
+	DUCT_ASSERTE("b.script" == config.includes[1u]);
+	DUCT_ASSERTE(3u == config.tags.size() && "sea" == config.tags[1u]);
+	DUCT_ASSERTE(2u == config.servers.size());
+
+	auto const& first = config.servers[0u];
+	DUCT_ASSERTE("localhost" == first.host);
+	DUCT_ASSERTE(8080 == first.port && first.secure);
+	DUCT_ASSERTE((std::vector<signed>{1, 2, 3}) == first.ports);
+	DUCT_ASSERTE(3u == first.matrix.size());
+	DUCT_ASSERTE(2u == first.matrix[0u].size() && same(0.5f, first.matrix[0u][1u]));
+	DUCT_ASSERTE(first.matrix[1u].empty() && same(-2.0f, first.matrix[2u][0u]));
+	DUCT_ASSERTE(10u == first.limits.connections);
+	DUCT_ASSERTE(same(1.0, first.limits.timeout));
+
+	auto const& second = config.servers[1u];
+	DUCT_ASSERTE("example.com" == second.host && 0 == second.port);
+	DUCT_ASSERTE(0u == second.limits.connections);
+	DUCT_ASSERTE(same(2.5, second.limits.timeout));
+
+	// Arrays replace the previous elements
+	binder.reset(config.servers[0u], &parser);
+	char const ports[] = "ports=[4]";
+	DUCT_ASSERTE(parser.process(binder, ports, ports + std::strlen(ports)));
+	DUCT_ASSERTE((std::vector<signed>{4}) == config.servers[0u].ports);
+	DUCT_ASSERTE(8080 == config.servers[0u].port);
+
+	// Errors
+	using Error = duct::ScriptBindingError;
+	DUCT_ASSERTE(Error::unknown_field == bind_error("nonexistent=1"));
+	DUCT_ASSERTE(Error::unknown_field == bind_error("server={x=[1]}"));
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("name=1"));
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("server=1"));
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("server={port=1.5}"));
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("server={ports=[true]}"));
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("server={limits=[]}"));
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("tags=[a]"));
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("include={}"));
+	DUCT_ASSERTE(
+		Error::invalid_value ==
+		bind_error("server={limits={connections=-1}}")
+	);
+	DUCT_ASSERTE(
+		Error::invalid_value ==
+		bind_error("server={port=99999999999}")
+	);
+
+	// Unknown names can be skipped
+	DUCT_ASSERTE(
+		static_cast<Error>(~0u) ==
+		bind_error("x=1 y={z=[1, [2]]} name=a server={w 1 2\n}", true)
+	);
+	DUCT_ASSERTE(Error::type_mismatch == bind_error("x=1 name=1", true));
+	return 0;
+}
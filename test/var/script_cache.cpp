@@ -0,0 +1,123 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/ScriptCache.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <iostream>
+
+static void
+write_file(
+	char const* const path,
+	char const* const data
+) {
+	std::ofstream stream{path, std::ios_base::binary | std::ios_base::trunc};
+	stream.write(data, static_cast<std::streamsize>(std::strlen(data)));
+}
+
+static char const
+s_data[] =
+	"name=value\n"
+	"server={port=80 hosts=[a, b] ratio=0.25}\n"
+	"ident 1 2 x=true\n"
+;
+
+signed
+main() {
+	char const* const path = "script_cache.tmp";
+	write_file(path, s_data);
+	duct::Var expected{};
+	duct::ScriptParser parser{};
+	DUCT_ASSERTE(parser.process(expected, s_data, s_data + std::strlen(s_data)));
+
+	duct::ScriptCache cache{"."};
+	auto const snapshot = cache.snapshot_path(path);
+	std::remove(snapshot.c_str());
+
+	// The first load parses and writes the snapshot
+	duct::Var root{};
+	DUCT_ASSERTE(cache.process_file(root, path));
+	DUCT_ASSERTE(root.equals(expected));
+	DUCT_ASSERTE(0u == cache.hits() && 1u == cache.misses());
+	DUCT_ASSERTE(std::ifstream{snapshot.c_str()}.is_open());
+
+	// Later loads read the snapshot
+	for (unsigned i = 0u; 3u > i; ++i) {
+		duct::Var cached{};
+		DUCT_ASSERTE(cache.process_file(cached, path));
+		DUCT_ASSERTE(cached.equals(expected));
+	}
+	DUCT_ASSERTE(3u == cache.hits() && 1u == cache.misses());
+
+	// Changed contents are parsed and the snapshot rewritten
+	write_file(path, "name=changed\n");
+	DUCT_ASSERTE(cache.process_file(root, path));
+	DUCT_ASSERTE(1u == root.size() && "changed" == root.front().string_ref());
+	DUCT_ASSERTE(3u == cache.hits() && 2u == cache.misses());
+	DUCT_ASSERTE(cache.process_file(root, path));
+	DUCT_ASSERTE("changed" == root.front().string_ref());
+	DUCT_ASSERTE(4u == cache.hits() && 2u == cache.misses());
+
+	// A corrupt snapshot is a miss
+	write_file(snapshot.c_str(), "corrupt");
+	DUCT_ASSERTE(cache.process_file(root, path));
+	DUCT_ASSERTE("changed" == root.front().string_ref());
+	DUCT_ASSERTE(4u == cache.hits() && 3u == cache.misses());
+
+	// Concurrent writers use their own temporary files
+	std::string const shared_temporary = snapshot + ".tmp";
+	write_file(shared_temporary.c_str(), "unrelated");
+	for (unsigned round = 0u; 8u > round; ++round) {
+		std::remove(snapshot.c_str());
+		std::vector<std::thread> threads{};
+		for (unsigned index = 0u; 4u > index; ++index) {
+			threads.emplace_back([path]() {
+				duct::ScriptCache writer{"."};
+				duct::Var loaded{};
+				DUCT_ASSERTE(writer.process_file(loaded, path));
+				DUCT_ASSERTE("changed" == loaded.front().string_ref());
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		DUCT_ASSERTE(cache.process_file(root, path));
+		DUCT_ASSERTE("changed" == root.front().string_ref());
+	}
+	DUCT_ASSERTE(12u == cache.hits() && 3u == cache.misses());
+	std::ifstream shared_stream{shared_temporary.c_str()};
+	std::string shared_data{};
+	DUCT_ASSERTE(std::getline(shared_stream, shared_data) && "unrelated" == shared_data);
+	shared_stream.close();
+	std::remove(shared_temporary.c_str());
+
+	// Parse errors are not cached
+	write_file(path, "name=");
+	bool thrown = false;
+	try {
+		cache.process_file(root, path);
+	} catch (duct::ScriptParserException& e) {
+		std::cout << e.what() << '\n';
+		thrown = true;
+	}
+	DUCT_ASSERTE(thrown && 4u == cache.misses());
+	DUCT_ASSERTE("changed" == root.front().string_ref());
+
+	std::remove(path);
+	DUCT_ASSERTE(!cache.process_file(root, path));
+	std::remove(snapshot.c_str());
+	cache.reset_counts();
+	DUCT_ASSERTE(0u == cache.hits() && 0u == cache.misses());
+	std::cout
+		<< "snapshot: " << snapshot << '\n'
+	;
+	return 0;
+}
@@ -0,0 +1,101 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/ScriptDocument.hpp>
+
+#include <cstring>
+#include <string>
+#include <iostream>
+
+static char const
+s_data[] =
+	"server={\n"
+	"\tport=80\n"
+	"\tinner={x=1 y=[2, [3]]}\n"
+	"}\n"
+	"client={name=\"a}b\" // }\n"
+	"\tlist=[1, 2] /* { */\n"
+	"}\n"
+	"value=1\n"
+	"{}\n"
+	"bad={\n"
+	"\tok=true\n"
+	"\tx=\n"
+	"}\n"
+;
+
+signed
+main() {
+	char const* const end = s_data + std::strlen(s_data);
+	duct::ScriptParser parser{};
+
+	duct::ScriptDocument doc{};
+	DUCT_ASSERTE(doc.assign(s_data, end));
+	auto& root = doc.root();
+	DUCT_ASSERTE(5u == root.size());
+	DUCT_ASSERTE(4u == doc.unloaded_count());
+	DUCT_ASSERTE(doc.is_loaded(root));
+	DUCT_ASSERTE(!doc.is_loaded(root.front()) && root.front().empty());
+	DUCT_ASSERTE(1 == root.at(2u).integer());
+
+	// Nodes are loaded one level at a time
+	auto* const server = doc.find("server");
+	DUCT_ASSERTE(nullptr != server && doc.is_loaded(*server));
+	DUCT_ASSERTE(2u == server->size());
+	DUCT_ASSERTE(80 == server->front().integer());
+	auto& inner = server->back();
+	DUCT_ASSERTE(!doc.is_loaded(inner) && inner.empty());
+	DUCT_ASSERTE(4u == doc.unloaded_count());
+	DUCT_ASSERTE(&doc.load(inner) == &inner && doc.is_loaded(inner));
+	DUCT_ASSERTE(2u == inner.size());
+	DUCT_ASSERTE(3 == inner.back().back().front().integer());
+
+	auto* const client = doc.find(root, "client");
+	DUCT_ASSERTE(nullptr != client && 2u == client->size());
+	DUCT_ASSERTE("a}b" == client->front().string_ref());
+	DUCT_ASSERTE(nullptr == doc.find("nonexistent"));
+
+	// Errors are reported when loading, as by process()
+	std::string message{};
+	try {
+		duct::Var processed{};
+		parser.process(processed, s_data, end);
+	} catch (duct::ScriptParserException& e) {
+		message = e.what();
+	}
+	std::cout << message << '\n';
+	DUCT_ASSERTE(!message.empty());
+	auto& bad = root.back();
+	for (unsigned attempt = 0u; 2u > attempt; ++attempt) {
+		try {
+			doc.load(bad);
+			DUCT_ASSERTE(false);
+		} catch (duct::ScriptParserException& e) {
+			DUCT_ASSERTE(message == e.what());
+		}
+		DUCT_ASSERTE(!doc.is_loaded(bad) && bad.empty());
+	}
+
+	// Fully loaded documents are identical to processed ones
+	char const* const good_end = std::strstr(s_data, "bad=");
+	duct::Var processed{};
+	DUCT_ASSERTE(parser.process(processed, s_data, good_end));
+	DUCT_ASSERTE(doc.assign(s_data, good_end));
+	DUCT_ASSERTE(doc.load_all().equals(processed));
+	DUCT_ASSERTE(0u == doc.unloaded_count());
+
+	// Deferred bodies can be processed directly
+	duct::ScriptParser::deferred_vector_type deferred{};
+	duct::Var shallow{};
+	DUCT_ASSERTE(parser.process_deferred(shallow, s_data, good_end, deferred));
+	DUCT_ASSERTE(3u == deferred.size());
+	DUCT_ASSERTE(0u == deferred[0u].index && 1u == deferred[1u].index);
+	DUCT_ASSERTE(3u == deferred[2u].index);
+	DUCT_ASSERTE(5 == deferred[1u].line && 9 == deferred[1u].column);
+	parser.process_deferred(shallow.at(1u), deferred[1u], deferred);
+	DUCT_ASSERTE(shallow.at(1u).equals(processed.at(1u)));
+	return 0;
+}
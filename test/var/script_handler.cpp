@@ -0,0 +1,180 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/CharBuf.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptHandler.hpp>
+#include <duct/ScriptParser.hpp>
+
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <iostream>
+
+// Records events as text
+struct RecordHandler final
+	: public duct::ScriptHandler
+{
+	std::string events{};
+
+	void
+	append(
+		char const* const event,
+		duct::CharBuf const& name
+	) {
+		events += event;
+		events += '(';
+		events += name.to_string<std::string>();
+		events += ") ";
+	}
+
+	void on_node_begin(duct::CharBuf const& name) override {
+		append("node", name);
+	}
+	void on_node_end() override {
+		events += "/node ";
+	}
+	void on_identifier_begin(duct::CharBuf const& name) override {
+		append("ident", name);
+	}
+	void on_identifier_end() override {
+		events += "/ident ";
+	}
+	void on_array_begin(duct::CharBuf const& name) override {
+		append("array", name);
+	}
+	void on_array_end() override {
+		events += "/array ";
+	}
+	void on_value(
+		duct::CharBuf const& name,
+		duct::VarType const type,
+		duct::CharBuf const& text
+	) override {
+		events += duct::var_type_name(type);
+		events += '(';
+		events += name.to_string<std::string>();
+		events += ':';
+		events += text.to_string<std::string>();
+		events += ") ";
+	}
+};
+
+// Collects the values of every "port" at any depth
+struct PortHandler final
+	: public duct::ScriptHandler
+{
+	std::string ports{};
+
+	void on_value(
+		duct::CharBuf const& name,
+		duct::VarType const type,
+		duct::CharBuf const& text
+	) override {
+		signed value;
+		if (
+			duct::VarType::integer == type &&
+			name.to_string<std::string>() == "port" &&
+			text.to_arithmetic(value)
+		) {
+			ports += std::to_string(value) + ' ';
+		}
+	}
+};
+
+// Records the position of the current token for every value
+struct PositionHandler final
+	: public duct::ScriptHandler
+{
+	duct::ScriptParser const& parser;
+	std::string positions{};
+
+	explicit
+	PositionHandler(
+		duct::ScriptParser const& parser
+	)
+		: parser(parser)
+	{}
+
+	void on_value(
+		duct::CharBuf const&,
+		duct::VarType const,
+		duct::CharBuf const&
+	) override {
+		duct::Token const token = parser.token();
+		positions += std::to_string(token.line()) + ':';
+		positions += std::to_string(token.column()) + ' ';
+	}
+};
+
+static char const
+s_data[] =
+	"a=1 b=\"two\" c=3.5 d=true e=false f=null\n"
+	"ident x 2\n\n"
+	"arr=[1, [], \"s\"]\n"
+	"server={port=80 inner={port=8080}}\n"
+	"{ named_child=null }\n"
+	"empty\n"
+	"port=443\n"
+;
+
+static char const
+s_events[] =
+	"integer(a:1) string(b:two) decimal(c:3.5) "
+	"boolean(d:true) boolean(e:false) null(f:null) "
+	"ident(ident) string(:x) integer(:2) /ident "
+	"array(arr) integer(:1) array() /array string(:s) /array "
+	"node(server) integer(port:80) node(inner) integer(port:8080) "
+	"/node /node "
+	"node() null(named_child:null) /node "
+	"ident(empty) /ident "
+	"integer(port:443) "
+;
+
+signed
+main() {
+	duct::ScriptParser parser{};
+	char const* const end = s_data + std::strlen(s_data);
+
+	RecordHandler record{};
+	DUCT_ASSERTE(parser.process(record, s_data, end));
+	std::cout << record.events << '\n';
+	DUCT_ASSERTE(record.events == s_events);
+
+	// Fed data sends the same events
+	RecordHandler fed{};
+	parser.begin_feed(fed);
+	for (char const* pos = s_data; end != pos; ++pos) {
+		parser.feed(pos, 1u);
+	}
+	parser.end_feed();
+	DUCT_ASSERTE(fed.events == s_events);
+
+	// Tokens read from a source buffer resolve their position like
+	// tokens read from a stream
+	PositionHandler from_source{parser};
+	DUCT_ASSERTE(parser.process(from_source, s_data, end));
+	PositionHandler from_stream{parser};
+	std::istringstream stream{s_data};
+	DUCT_ASSERTE(parser.process(from_stream, stream));
+	std::cout << from_source.positions << '\n';
+	DUCT_ASSERTE(from_source.positions == from_stream.positions);
+	DUCT_ASSERTE(std::string::npos == from_source.positions.find('-'));
+
+	PortHandler ports{};
+	DUCT_ASSERTE(parser.process(ports, s_data, end));
+	std::cout << ports.ports << '\n';
+	DUCT_ASSERTE(ports.ports == "80 8080 443 ");
+
+	// The builder is what process(Var&) uses
+	duct::Var processed{duct::VarType::node};
+	DUCT_ASSERTE(parser.process(processed, s_data, end));
+	duct::Var built{};
+	duct::ScriptVarBuilder builder{built};
+	DUCT_ASSERTE(parser.process(builder, s_data, end));
+	DUCT_ASSERTE(built.is_type(duct::VarType::node));
+	DUCT_ASSERTE(processed.equals(built));
+	DUCT_ASSERTE(12u == built.size());
+	return 0;
+}
@@ -0,0 +1,79 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/aux.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptParser.hpp>
+#include <duct/ScriptLoader.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <iostream>
+
+using Status = duct::ScriptLoader::Status;
+
+static duct::u8string
+write_file(
+	unsigned const index
+) {
+	duct::u8string const path
+		= "script_loader_" + std::to_string(index) + ".tmp";
+	std::ofstream stream{path, std::ios_base::binary};
+	stream << "index=" << index << "\nnode={x=" << index << "}\n";
+	if (0u == index % 7u) {
+		stream << "broken={\n";
+	}
+	return path;
+}
+
+signed
+main() {
+	duct::aux::vector<duct::u8string> paths{};
+	for (unsigned index = 0u; 200u > index; ++index) {
+		paths.push_back(write_file(index));
+	}
+	paths.push_back("script_loader_nonexistent.tmp");
+
+	duct::ScriptParser parser{};
+	for (unsigned thread_count : {1u, 4u, 0u}) {
+		duct::ScriptLoader loader{thread_count};
+		auto const results = loader.process(paths);
+		DUCT_ASSERTE(paths.size() == results.size());
+		for (unsigned index = 0u; 200u > index; ++index) {
+			auto const& result = results[index];
+			duct::Var expected{};
+			if (0u == index % 7u) {
+				// Diagnostics are those of a sequential parser
+				DUCT_ASSERTE(Status::parse_error == result.status);
+				try {
+					parser.process_file(expected, paths[index]);
+					DUCT_ASSERTE(false);
+				} catch (duct::ScriptParserException& e) {
+					DUCT_ASSERTE(result.error == e.what());
+				}
+				DUCT_ASSERTE(result.root.empty());
+			} else {
+				DUCT_ASSERTE(Status::success == result.status);
+				DUCT_ASSERTE(parser.process_file(expected, paths[index]));
+				DUCT_ASSERTE(result.root.equals(expected));
+				DUCT_ASSERTE(
+					static_cast<signed>(index)
+					== result.root.front().integer()
+				);
+			}
+		}
+		DUCT_ASSERTE(Status::file_error == results.back().status);
+		std::cout
+			<< loader.thread_count() << " threads: "
+			<< results[7u].error << '\n'
+		;
+	}
+
+	for (auto const& path : paths) {
+		std::remove(path.c_str());
+	}
+	std::cout.flush();
+	return 0;
+}
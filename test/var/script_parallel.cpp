@@ -0,0 +1,100 @@
+
+#include <duct/config.hpp>
+#include <duct/string.hpp>
+#include <duct/debug.hpp>
+#include <duct/Var.hpp>
+#include <duct/ScriptParser.hpp>
+
+#include <string>
+#include <iostream>
+
+// Statements which cross lines or hide boundaries from the splitter
+static char const* const
+s_statements[]{
+	"a=1 b=\"two\" c=3.5 d=true e=null\n",
+	"ident x 2\n",
+	"y=3\n\n",
+	"quoted=\"first\nsecond\n}\n\"\n",
+	"// comment {\n",
+	"/* block\n[\n*/ z=4\n",
+	"node={\n\tinner={port=8080}\n\tarr=[1,\n\t\t2]\n}\n",
+	"{ unnamed=0 }\n",
+	"escaped=a\\=b \"\\\" {\"\n",
+	"\r\n",
+};
+
+static std::string
+make_document(
+	std::size_t const size
+) {
+	std::string doc{};
+	std::size_t index = 0u;
+	while (size > doc.size()) {
+		doc += s_statements[index % (sizeof(s_statements) / sizeof(char*))];
+		doc += "n" + std::to_string(index) + "=" + std::to_string(index) + "\n";
+		++index;
+	}
+	return doc;
+}
+
+static std::string
+error_message(
+	duct::ScriptParser& parser,
+	std::string const& doc,
+	bool const parallel
+) {
+	duct::Var root{};
+	try {
+		if (parallel) {
+			parser.process_parallel(
+				root, doc.data(), doc.data() + doc.size(), 4u
+			);
+		} else {
+			parser.process(root, doc.data(), doc.data() + doc.size());
+		}
+	} catch (duct::ScriptParserException& e) {
+		return e.what();
+	}
+	return {};
+}
+
+signed
+main() {
+	duct::ScriptParser parser{};
+	std::string const doc = make_document(1u << 21);
+	char const* const begin = doc.data();
+	char const* const end = begin + doc.size();
+
+	duct::Var sequential{};
+	DUCT_ASSERTE(parser.process(sequential, begin, end));
+	for (unsigned thread_count : {0u, 1u, 2u, 4u, 7u}) {
+		duct::Var parallel{};
+		DUCT_ASSERTE(
+			parser.process_parallel(parallel, begin, end, thread_count)
+		);
+		DUCT_ASSERTE(parallel.equals(sequential));
+	}
+	std::cout << sequential.size() << " values\n";
+
+	// Existing children are kept
+	duct::Var appended{duct::VarType::node};
+	appended.emplace_back("first", 1);
+	DUCT_ASSERTE(parser.process_parallel(appended, begin, end, 4u));
+	DUCT_ASSERTE(sequential.size() + 1u == appended.size());
+	DUCT_ASSERTE(appended.front().name() == "first");
+
+	// Errors are reported as by process()
+	std::string bad = doc;
+	bad.insert(bad.size() / 2u, "broken={\n");
+	std::string const message = error_message(parser, bad, false);
+	std::cout << message << '\n';
+	DUCT_ASSERTE(!message.empty());
+	DUCT_ASSERTE(error_message(parser, bad, true) == message);
+
+	bad = doc;
+	bad.insert(bad.rfind("\n", bad.size() / 3u) + 1u, "x=]\n");
+	DUCT_ASSERTE(
+		error_message(parser, bad, true) == error_message(parser, bad, false)
+	);
+	return 0;
+}
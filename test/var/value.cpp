@@ -1,6 +1,7 @@
 
 #include <duct/string.hpp>
 #include <duct/detail/var.hpp>
+#include <duct/debug.hpp>
 #include <duct/Var.hpp>
 
 #include <iomanip>
@@ -34,6 +35,29 @@ main() {
 	morph_var.morph(23.12f);
 	print_var(morph_var);
 
+	// Strings and children share storage with the numeric values
+	DUCT_ASSERTE(
+		sizeof(duct::Var) <=
+		sizeof(duct::detail::var_config::name_type) + 2u * sizeof(std::uint64_t)
+	);
+	morph_var.morph(duct::u8string("asdf"));
+	morph_var.morph(duct::VarType::array);
+	DUCT_ASSERTE(morph_var.empty());
+	morph_var.emplace_back(string_var);
+	morph_var.emplace_back(duct::VarType::node);
+	morph_var.back().push_back(int_var);
+	morph_var.morph(duct::VarType::node, false);
+	DUCT_ASSERTE(2u == morph_var.size());
+	duct::Var copy_var{morph_var};
+	DUCT_ASSERTE(copy_var.equals(morph_var));
+	copy_var = copy_var.back();
+	DUCT_ASSERTE(1u == copy_var.size() && copy_var.front().equals(int_var));
+	copy_var = std::move(morph_var.front());
+	DUCT_ASSERTE(copy_var.equals(string_var));
+	DUCT_ASSERTE(morph_var.front().string_ref().empty());
+	morph_var.morph(duct::u8string{});
+	DUCT_ASSERTE(morph_var.string_ref().empty());
+
 	std::cout.flush();
 	return 0;
 }